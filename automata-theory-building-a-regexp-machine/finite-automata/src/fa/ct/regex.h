@@ -0,0 +1,632 @@
+#ifndef FA_CT_REGEX_H
+#define FA_CT_REGEX_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+namespace fa::ct
+{
+    /**
+     * Maximum number of symbol occurrences (positions) in a compile-time expression.
+     */
+    constexpr size_t MAX_POSITIONS = 63;
+
+    /**
+     * Maximum number of states of a compile-time DFA.
+     */
+    constexpr size_t MAX_STATES = 256;
+
+    /**
+     * A set of bytes, as a 256 bits bitset.
+     */
+    struct ByteSet {
+        uint64_t words[4] = {};
+
+        constexpr void add(unsigned from, unsigned to)
+        {
+            for (unsigned c = from; c <= to; c++) {
+                this->words[c / 64] |= uint64_t{ 1 } << (c % 64);
+            }
+        }
+
+        constexpr void negate()
+        {
+            for (uint64_t& word: this->words) {
+                word = ~word;
+            }
+        }
+
+        [[nodiscard]]
+        constexpr bool contains(unsigned char c) const
+        {
+            return (this->words[c / 64] >> (c % 64)) & 1;
+        }
+    };
+
+    /**
+     * Compile-time Regular Expression.
+     *
+     * The Glushkov (position automaton) construction, with every set of positions as a bitmask,
+     * so the same combinators as the NFA fragments (concat, disjoint, zeroOrMore, oneOrMore, opt,
+     * range) are plain constexpr functions over a fixed capacity value.
+     *
+     * Going beyond MAX_POSITIONS throws, which makes a constant evaluation fail to compile.
+     */
+    struct Expr {
+        size_t position_count = 0;
+        bool nullable = true;
+        // positions that may read the first (last) byte of a match
+        uint64_t first = 0;
+        uint64_t last = 0;
+        // positions that may come right after every position
+        uint64_t follow[MAX_POSITIONS] = {};
+        // the bytes read by every position
+        ByteSet symbols[MAX_POSITIONS] = {};
+
+        /**
+         * Epsilon (empty string) expression.
+         */
+        constexpr Expr() = default;
+
+        /**
+         * A single position, reading any of the given bytes.
+         */
+        constexpr explicit Expr(const ByteSet& symbol)
+            : position_count(1)
+            , nullable(false)
+            , first(1)
+            , last(1)
+        {
+            this->symbols[0] = symbol;
+        }
+
+        /**
+         * Single character (byte) expression.
+         */
+        constexpr Expr(char c)
+            : Expr(byte_set(c))
+        {
+        }
+
+        /**
+         * Concatenation.
+         */
+        [[nodiscard]]
+        constexpr Expr operator+(const Expr& other) const
+        {
+            Expr resulting = this->append_positions(other);
+            const size_t shift = this->position_count;
+            for (size_t position = 0; position < this->position_count; position++) {
+                if ((this->last >> position) & 1) {
+                    resulting.follow[position] |= other.first << shift;
+                }
+            }
+            resulting.nullable = this->nullable && other.nullable;
+            resulting.first = this->first | (this->nullable ? other.first << shift : 0);
+            resulting.last = (other.last << shift) | (other.nullable ? this->last : 0);
+            return resulting;
+        }
+
+        /**
+         * Union.
+         */
+        [[nodiscard]]
+        constexpr Expr operator|(const Expr& other) const
+        {
+            Expr resulting = this->append_positions(other);
+            const size_t shift = this->position_count;
+            resulting.nullable = this->nullable || other.nullable;
+            resulting.first = this->first | (other.first << shift);
+            resulting.last = this->last | (other.last << shift);
+            return resulting;
+        }
+
+    protected:
+        static constexpr ByteSet byte_set(char c)
+        {
+            ByteSet set;
+            set.add(static_cast<unsigned char>(c), static_cast<unsigned char>(c));
+            return set;
+        }
+
+        /**
+         * Copy of this expression followed by the (renumbered) positions of the other one.
+         */
+        constexpr Expr append_positions(const Expr& other) const
+        {
+            if (this->position_count + other.position_count > MAX_POSITIONS) {
+                throw std::length_error{ "too many positions for a compile-time expression" };
+            }
+            Expr resulting = *this;
+            const size_t shift = this->position_count;
+            for (size_t position = 0; position < other.position_count; position++) {
+                resulting.follow[shift + position] = other.follow[position] << shift;
+                resulting.symbols[shift + position] = other.symbols[position];
+            }
+            resulting.position_count += other.position_count;
+            return resulting;
+        }
+    };
+
+    /**
+     * Fold left all expressions using the concatenation '+' operator.
+     */
+    template <typename... ExprArgs>
+    constexpr Expr concat(ExprArgs... exprs) {
+        return (... + Expr{ exprs });
+    }
+
+    /**
+     * Fold left all expressions using the union '|' operator.
+     */
+    template <typename... ExprArgs>
+    constexpr Expr disjoint(ExprArgs... exprs) {
+        return (... | Expr{ exprs });
+    }
+
+    /**
+     * Loops the last positions back to the first ones.
+     */
+    constexpr Expr loop(Expr a)
+    {
+        for (size_t position = 0; position < a.position_count; position++) {
+            if ((a.last >> position) & 1) {
+                a.follow[position] |= a.first;
+            }
+        }
+        return a;
+    }
+
+    /**
+     * a*.
+     */
+    constexpr Expr zeroOrMore(const Expr& a)
+    {
+        Expr resulting = loop(a);
+        resulting.nullable = true;
+        return resulting;
+    }
+
+    /**
+     * a+.
+     */
+    constexpr Expr oneOrMore(const Expr& a)
+    {
+        return loop(a);
+    }
+
+    /**
+     * a?.
+     */
+    constexpr Expr opt(Expr a)
+    {
+        a.nullable = true;
+        return a;
+    }
+
+    /**
+     * Character class (range) [from-to], a single position.
+     */
+    constexpr Expr range(char from, char to)
+    {
+        if (static_cast<unsigned char>(from) > static_cast<unsigned char>(to)) {
+            throw std::invalid_argument{ "invalid range" };
+        }
+        ByteSet set;
+        set.add(static_cast<unsigned char>(from), static_cast<unsigned char>(to));
+        return Expr{ set };
+    }
+
+    /**
+     * Compile-time DFA, with its tables sized to fit.
+     *
+     * State 0 is the dead state and state 1 the starting one.
+     */
+    template <size_t StateCount, size_t ClassCount>
+    struct DFA {
+        static constexpr uint8_t DEAD_STATE = 0;
+        static constexpr uint8_t STARTING_STATE = 1;
+
+        std::array<uint8_t, 256> classes = {};
+        std::array<uint8_t, StateCount * ClassCount> transitions = {};
+        std::array<bool, StateCount> accepting = {};
+
+        [[nodiscard]]
+        constexpr uint8_t next(uint8_t state, unsigned char c) const
+        {
+            return this->transitions[state * ClassCount + this->classes[c]];
+        }
+
+        /**
+         * Verifies if the whole given input matches.
+         */
+        [[nodiscard]]
+        constexpr bool matches(std::string_view input) const
+        {
+            uint8_t state = STARTING_STATE;
+            for (char c: input) {
+                state = this->next(state, static_cast<unsigned char>(c));
+                if (state == DEAD_STATE) {
+                    return false;
+                }
+            }
+            return this->accepting[state];
+        }
+
+        /**
+         * Length of the longest prefix of the input matching, if any.
+         */
+        [[nodiscard]]
+        constexpr std::optional<size_t> longest_match(std::string_view input) const
+        {
+            uint8_t state = STARTING_STATE;
+            std::optional<size_t> longest;
+            if (this->accepting[state]) {
+                longest = 0;
+            }
+            for (size_t i = 0; i < input.size(); i++) {
+                state = this->next(state, static_cast<unsigned char>(input[i]));
+                if (state == DEAD_STATE) {
+                    break;
+                }
+                if (this->accepting[state]) {
+                    longest = i + 1;
+                }
+            }
+            return longest;
+        }
+
+        [[nodiscard]]
+        static constexpr size_t get_state_count()
+        {
+            return StateCount;
+        }
+
+        [[nodiscard]]
+        static constexpr size_t get_class_count()
+        {
+            return ClassCount;
+        }
+    };
+
+    namespace detail
+    {
+        /**
+         * The subset construction over the positions of an expression, at full capacity.
+         *
+         * DFA states are sets of positions, plus a bit for the Glushkov starting state.
+         */
+        struct Subsets {
+            static constexpr uint64_t STARTING = uint64_t{ 1 } << MAX_POSITIONS;
+
+            size_t state_count = 0;
+            size_t class_count = 0;
+            uint8_t classes[256] = {};
+            uint64_t sets[MAX_STATES] = {};
+            bool accepting[MAX_STATES] = {};
+            uint8_t transitions[MAX_STATES][256] = {};
+        };
+
+        constexpr Subsets subset_construction(const Expr& expr)
+        {
+            Subsets subsets;
+
+            // bytes read by the same positions are equivalent
+            uint64_t byte_positions[256] = {};
+            unsigned char representatives[256] = {};
+            for (unsigned c = 0; c < 256; c++) {
+                for (size_t position = 0; position < expr.position_count; position++) {
+                    if (expr.symbols[position].contains(static_cast<unsigned char>(c))) {
+                        byte_positions[c] |= uint64_t{ 1 } << position;
+                    }
+                }
+                size_t byte_class = 0;
+                while (byte_class < subsets.class_count && byte_positions[representatives[byte_class]] != byte_positions[c]) {
+                    byte_class++;
+                }
+                if (byte_class == subsets.class_count) {
+                    representatives[subsets.class_count++] = static_cast<unsigned char>(c);
+                }
+                subsets.classes[c] = static_cast<uint8_t>(byte_class);
+            }
+
+            // the dead state (no positions at all) and the starting state
+            subsets.sets[0] = 0;
+            subsets.sets[1] = Subsets::STARTING;
+            subsets.state_count = 2;
+            for (size_t state = 1; state < subsets.state_count; state++) {
+                const uint64_t set = subsets.sets[state];
+                uint64_t follow = (set & Subsets::STARTING) ? expr.first : 0;
+                for (size_t position = 0; position < expr.position_count; position++) {
+                    if ((set >> position) & 1) {
+                        follow |= expr.follow[position];
+                    }
+                }
+                subsets.accepting[state] = (set & expr.last) || ((set & Subsets::STARTING) && expr.nullable);
+
+                for (size_t byte_class = 0; byte_class < subsets.class_count; byte_class++) {
+                    const uint64_t next_set = follow & byte_positions[representatives[byte_class]];
+                    size_t next_state = 0;
+                    while (next_state < subsets.state_count && subsets.sets[next_state] != next_set) {
+                        next_state++;
+                    }
+                    if (next_state == subsets.state_count) {
+                        if (subsets.state_count == MAX_STATES) {
+                            throw std::length_error{ "too many states for a compile-time DFA" };
+                        }
+                        subsets.sets[subsets.state_count++] = next_set;
+                    }
+                    subsets.transitions[state][byte_class] = static_cast<uint8_t>(next_state);
+                }
+            }
+
+            return subsets;
+        }
+
+        /**
+         * Recursive descent parser of the fa::nfa::compile syntax, but counted repetitions.
+         */
+        class Parser
+        {
+        protected:
+            std::string_view pattern;
+            size_t position = 0;
+
+            [[nodiscard]]
+            constexpr bool at_end() const
+            {
+                return this->position == this->pattern.size();
+            }
+
+            [[nodiscard]]
+            constexpr char peek() const
+            {
+                return this->pattern[this->position];
+            }
+
+            static constexpr bool class_escape(char c, ByteSet& set)
+            {
+                ByteSet escape;
+                switch (c) {
+                case 'd': case 'D':
+                    escape.add('0', '9');
+                    break;
+                case 'w': case 'W':
+                    escape.add('a', 'z');
+                    escape.add('A', 'Z');
+                    escape.add('0', '9');
+                    escape.add('_', '_');
+                    break;
+                case 's': case 'S':
+                    escape.add(' ', ' ');
+                    escape.add('\t', '\r');
+                    break;
+                default:
+                    return false;
+                }
+                if (c >= 'A' && c <= 'Z') {
+                    escape.negate();
+                }
+                for (size_t i = 0; i < 4; i++) {
+                    set.words[i] |= escape.words[i];
+                }
+                return true;
+            }
+
+            static constexpr char escaped_byte(char c)
+            {
+                switch (c) {
+                case 'n': return '\n';
+                case 't': return '\t';
+                case 'r': return '\r';
+                case 'f': return '\f';
+                case 'v': return '\v';
+                default:
+                    break;
+                }
+                if (std::string_view{ "\\|()[]{}*+?.^$-/" }.find(c) == std::string_view::npos) {
+                    throw std::invalid_argument{ "unknown escape" };
+                }
+                return c;
+            }
+
+            constexpr char next_byte()
+            {
+                if (this->at_end()) {
+                    throw std::invalid_argument{ "unexpected end of pattern" };
+                }
+                return this->pattern[this->position++];
+            }
+
+            constexpr Expr alternation()
+            {
+                Expr resulting = this->concatenation();
+                while (!this->at_end() && this->peek() == '|') {
+                    this->position++;
+                    resulting = resulting | this->concatenation();
+                }
+                return resulting;
+            }
+
+            constexpr Expr concatenation()
+            {
+                Expr resulting;
+                while (!this->at_end() && this->peek() != '|' && this->peek() != ')') {
+                    resulting = resulting + this->repetition();
+                }
+                return resulting;
+            }
+
+            constexpr Expr repetition()
+            {
+                Expr resulting = this->atom();
+                while (!this->at_end()) {
+                    char c = this->peek();
+                    if (c == '*') {
+                        resulting = zeroOrMore(resulting);
+                    } else if (c == '+') {
+                        resulting = oneOrMore(resulting);
+                    } else if (c == '?') {
+                        resulting = opt(resulting);
+                    } else {
+                        break;
+                    }
+                    this->position++;
+                }
+                return resulting;
+            }
+
+            constexpr Expr atom()
+            {
+                char c = this->next_byte();
+                ByteSet set;
+                switch (c) {
+                case '(': {
+                    Expr group = this->alternation();
+                    if (this->next_byte() != ')') {
+                        throw std::invalid_argument{ "missing )" };
+                    }
+                    return group;
+                }
+                case '[':
+                    return this->bracket_class();
+                case '.':
+                    set.add('\n', '\n');
+                    set.negate();
+                    return Expr{ set };
+                case '\\':
+                    c = this->next_byte();
+                    if (!class_escape(c, set)) {
+                        return Expr{ escaped_byte(c) };
+                    }
+                    return Expr{ set };
+                case '*': case '+': case '?': case '{':
+                    throw std::invalid_argument{ "nothing to repeat" };
+                case ')': case ']':
+                    throw std::invalid_argument{ "unmatched bracket" };
+                default:
+                    return Expr{ c };
+                }
+            }
+
+            constexpr char class_byte()
+            {
+                char c = this->next_byte();
+                return c == '\\' ? escaped_byte(this->next_byte()) : c;
+            }
+
+            constexpr Expr bracket_class()
+            {
+                ByteSet set;
+                bool negated = !this->at_end() && this->peek() == '^';
+                if (negated) {
+                    this->position++;
+                }
+                for (bool first = true; ; first = false) {
+                    if (this->at_end()) {
+                        throw std::invalid_argument{ "missing ]" };
+                    }
+                    if (this->peek() == ']' && !first) {
+                        this->position++;
+                        break;
+                    }
+                    if (this->peek() == '\\' && this->position + 1 < this->pattern.size()
+                        && class_escape(this->pattern[this->position + 1], set)) {
+                        this->position += 2;
+                        continue;
+                    }
+                    auto from = static_cast<unsigned char>(this->class_byte());
+                    auto to = from;
+                    if (this->position + 1 < this->pattern.size() && this->peek() == '-' && this->pattern[this->position + 1] != ']') {
+                        this->position++;
+                        to = static_cast<unsigned char>(this->class_byte());
+                        if (from > to) {
+                            throw std::invalid_argument{ "invalid class range" };
+                        }
+                    }
+                    set.add(from, to);
+                }
+                if (negated) {
+                    set.negate();
+                }
+                return Expr{ set };
+            }
+
+        public:
+            constexpr explicit Parser(std::string_view pattern)
+                : pattern(pattern)
+            {
+            }
+
+            constexpr Expr parse()
+            {
+                Expr expr = this->alternation();
+                if (!this->at_end()) {
+                    throw std::invalid_argument{ "unmatched )" };
+                }
+                return expr;
+            }
+        };
+
+        template <size_t StateCount, size_t ClassCount>
+        constexpr DFA<StateCount, ClassCount> to_dfa(const Subsets& subsets)
+        {
+            DFA<StateCount, ClassCount> dfa;
+            for (size_t c = 0; c < 256; c++) {
+                dfa.classes[c] = subsets.classes[c];
+            }
+            for (size_t state = 0; state < StateCount; state++) {
+                dfa.accepting[state] = subsets.accepting[state];
+                for (size_t byte_class = 0; byte_class < ClassCount; byte_class++) {
+                    dfa.transitions[state * ClassCount + byte_class] = subsets.transitions[state][byte_class];
+                }
+            }
+            return dfa;
+        }
+    }
+
+    /**
+     * Parses a pattern (see fa::nfa::compile, but counted repetitions) at compile time.
+     */
+    constexpr Expr parse(std::string_view pattern)
+    {
+        return detail::Parser{ pattern }.parse();
+    }
+
+    /**
+     * Compiles the given pattern into a DFA, entirely at compile time:
+     *
+     *     static constexpr char pattern[] = "xy*|z";
+     *     constexpr auto matcher = fa::ct::compile<pattern>();
+     *     static_assert(matcher.matches("xyy"));
+     *
+     * C++17 can't take a string literal as a template argument, so the pattern has to be a named
+     * constexpr array. Invalid patterns, or ones needing more than MAX_POSITIONS positions or
+     * MAX_STATES states, fail to compile.
+     */
+    template <const char* Pattern>
+    constexpr auto compile()
+    {
+        constexpr detail::Subsets subsets = detail::subset_construction(parse(Pattern));
+        return detail::to_dfa<subsets.state_count, subsets.class_count>(subsets);
+    }
+
+    /**
+     * Compiles the given (constexpr, static) expression into a DFA, entirely at compile time:
+     *
+     *     static constexpr fa::ct::Expr expr = fa::ct::concat('x', fa::ct::zeroOrMore('y'));
+     *     constexpr auto matcher = fa::ct::compile<expr>();
+     */
+    template <const Expr& E>
+    constexpr auto compile()
+    {
+        constexpr detail::Subsets subsets = detail::subset_construction(E);
+        return detail::to_dfa<subsets.state_count, subsets.class_count>(subsets);
+    }
+}
+
+#endif
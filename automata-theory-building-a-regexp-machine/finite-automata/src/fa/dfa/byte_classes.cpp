@@ -0,0 +1,53 @@
+#include "byte_classes.h"
+
+#include <bitset>
+#include <cassert>
+
+using namespace std;
+using namespace fa;
+
+namespace fa::dfa
+{
+    ByteClasses::ByteClasses()
+        : class_count(1)
+    {
+        this->classes.fill(0);
+        this->representatives.fill(0);
+    }
+
+    ByteClasses::ByteClasses(const nfa::Automaton& automaton)
+    {
+        // boundaries[c] is set when c starts a new class
+        bitset<ALPHABET_SIZE> boundaries;
+        for (uint32_t state = 0; state < automaton.get_state_count(); state++) {
+            for (const auto& edge: automaton.get_transitions(state)) {
+                boundaries.set(edge.from);
+                if (edge.to + 1u < ALPHABET_SIZE) {
+                    boundaries.set(edge.to + 1u);
+                }
+            }
+        }
+
+        this->representatives.fill(0);
+        size_t byte_class = 0;
+        for (size_t c = 0; c < ALPHABET_SIZE; c++) {
+            if (c > 0 && boundaries.test(c)) {
+                byte_class++;
+                this->representatives[byte_class] = static_cast<uint8_t>(c);
+            }
+            this->classes[c] = static_cast<uint8_t>(byte_class);
+        }
+        this->class_count = byte_class + 1;
+        assert(this->class_count <= ALPHABET_SIZE);
+    }
+
+    size_t ByteClasses::get_class_count() const
+    {
+        return this->class_count;
+    }
+
+    const array<uint8_t, ByteClasses::ALPHABET_SIZE>& ByteClasses::get_classes() const
+    {
+        return this->classes;
+    }
+}
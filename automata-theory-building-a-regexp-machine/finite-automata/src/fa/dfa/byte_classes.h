@@ -0,0 +1,63 @@
+#ifndef FA_DFA_BYTE_CLASSES_H
+#define FA_DFA_BYTE_CLASSES_H
+
+#include <array>
+#include <cstdint>
+
+#include <fa/nfa/automaton.h>
+
+namespace fa::dfa
+{
+    /**
+     * Byte Equivalence Classes.
+     *
+     * Partitions the 256 possible input bytes in classes of bytes that no transition of an
+     * automaton tells apart: every transition interval either contains all bytes of a class
+     * or none of them. DFA tables then only need one column per class instead of one per byte.
+     *
+     * Classes are numbered in byte order, so the bytes of each class form a contiguous interval.
+     */
+    class ByteClasses
+    {
+    public:
+        static constexpr size_t ALPHABET_SIZE = 256;
+
+    protected:
+        std::array<uint8_t, ALPHABET_SIZE> classes;
+        std::array<uint8_t, ALPHABET_SIZE> representatives;
+        size_t class_count;
+
+    public:
+        /**
+         * A single class containing all bytes.
+         */
+        ByteClasses();
+
+        explicit ByteClasses(const fa::nfa::Automaton& automaton);
+
+        [[nodiscard]]
+        uint8_t get(unsigned char c) const
+        {
+            return this->classes[c];
+        }
+
+        /**
+         * The first (smallest) byte of the given class.
+         */
+        [[nodiscard]]
+        unsigned char get_representative(size_t byte_class) const
+        {
+            return this->representatives[byte_class];
+        }
+
+        // GETTERS
+
+        [[nodiscard]]
+        size_t get_class_count() const;
+
+        [[nodiscard]]
+        const std::array<uint8_t, ALPHABET_SIZE>& get_classes() const;
+    };
+}
+
+#endif
@@ -0,0 +1,148 @@
+#include "codegen.h"
+
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+
+namespace fa::dfa
+{
+    vector<ByteRun> byte_runs(const Table& table, uint32_t state)
+    {
+        vector<ByteRun> runs;
+        for (unsigned c = 0; c < ByteClasses::ALPHABET_SIZE; c++) {
+            uint32_t target = table.next(state, static_cast<unsigned char>(c));
+            if (!runs.empty() && runs.back().target == target) {
+                runs.back().to = c;
+            } else {
+                runs.push_back(ByteRun{ c, c, target });
+            }
+        }
+        return runs;
+    }
+
+    static string hex_byte(unsigned byte)
+    {
+        ostringstream os;
+        os << "0x" << hex << setw(2) << setfill('0') << byte;
+        return os.str();
+    }
+
+    static void generate_goto_matcher(ostream& os, const Table& table)
+    {
+        os << "    const unsigned char* p = reinterpret_cast<const unsigned char*>(input.data());\n";
+        os << "    const unsigned char* const end = p + input.size();\n";
+        os << "    unsigned char c;\n";
+        if (table.get_starting_state() == Table::DEAD_STATE) {
+            os << "    (void) end;\n";
+            os << "    (void) c;\n";
+            os << "    return false;\n";
+            return;
+        }
+        os << "    goto s" << table.get_starting_state() << ";\n";
+
+        for (uint32_t state = 1; state < table.get_state_count(); state++) {
+            os << "s" << state << ":\n";
+            os << "    if (p == end) {\n";
+            os << "        return " << (table.is_accepting(state) ? "true" : "false") << ";\n";
+            os << "    }\n";
+            os << "    c = *p++;\n";
+
+            // the dead state is the fallback, so its runs need no comparison
+            vector<ByteRun> runs = byte_runs(table, state);
+            if (runs.size() == 1 && runs[0].target != Table::DEAD_STATE) {
+                os << "    goto s" << runs[0].target << ";\n";
+                continue;
+            }
+            for (const ByteRun& run: runs) {
+                if (run.target == Table::DEAD_STATE) {
+                    continue;
+                }
+                os << "    if (";
+                if (run.from == run.to) {
+                    os << "c == " << hex_byte(run.from);
+                } else if (run.from == 0) {
+                    os << "c <= " << hex_byte(run.to);
+                } else if (run.to == 0xff) {
+                    os << "c >= " << hex_byte(run.from);
+                } else {
+                    os << "c >= " << hex_byte(run.from) << " && c <= " << hex_byte(run.to);
+                }
+                os << ") goto s" << run.target << ";\n";
+            }
+            os << "    return false;\n";
+        }
+    }
+
+    static void generate_table_matcher(ostream& os, const Table& table)
+    {
+        const ByteClasses& byte_classes = table.get_byte_classes();
+        const size_t class_count = byte_classes.get_class_count();
+        const size_t state_count = table.get_state_count();
+        const char* state_type = state_count <= 0x100 ? "std::uint8_t" : state_count <= 0x10000 ? "std::uint16_t" : "std::uint32_t";
+
+        os << "    static constexpr std::uint8_t classes[256] = {";
+        for (size_t c = 0; c < ByteClasses::ALPHABET_SIZE; c++) {
+            os << (c % 16 == 0 ? "\n        " : " ") << unsigned{ byte_classes.get(static_cast<unsigned char>(c)) } << ",";
+        }
+        os << "\n    };\n";
+
+        os << "    static constexpr " << state_type << " transitions[" << state_count << "][" << class_count << "] = {\n";
+        for (uint32_t state = 0; state < state_count; state++) {
+            os << "        {";
+            for (size_t byte_class = 0; byte_class < class_count; byte_class++) {
+                os << (byte_class ? ", " : " ") << table.next(state, byte_classes.get_representative(byte_class));
+            }
+            os << " },\n";
+        }
+        os << "    };\n";
+
+        os << "    static constexpr bool accepting[" << state_count << "] = {";
+        for (uint32_t state = 0; state < state_count; state++) {
+            os << (state % 16 == 0 ? "\n        " : " ") << (table.is_accepting(state) ? "true" : "false") << ",";
+        }
+        os << "\n    };\n\n";
+
+        os << "    std::uint32_t state = " << table.get_starting_state() << ";\n";
+        os << "    for (unsigned char c: input) {\n";
+        os << "        state = transitions[state][classes[c]];\n";
+        os << "        if (state == " << Table::DEAD_STATE << ") {\n";
+        os << "            return false;\n";
+        os << "        }\n";
+        os << "    }\n";
+        os << "    return accepting[state];\n";
+    }
+
+    void generate_matcher(ostream& os, const Table& table, const string& name, CodeStyle style)
+    {
+        os << "/**\n";
+        os << " * " << table.get_state_count() << " states, " << table.get_byte_classes().get_class_count() << " byte classes.\n";
+        os << " */\n";
+        os << "inline bool " << name << "(std::string_view input) noexcept\n";
+        os << "{\n";
+        if (style == CodeStyle::GOTO) {
+            generate_goto_matcher(os, table);
+        } else {
+            generate_table_matcher(os, table);
+        }
+        os << "}\n";
+    }
+
+    string string_literal(string_view bytes)
+    {
+        ostringstream os;
+        os << '"';
+        for (unsigned char c: bytes) {
+            if (c == '"' || c == '\\') {
+                os << '\\' << c;
+            } else if (c >= 0x20 && c < 0x7f) {
+                os << c;
+            } else {
+                // octal, as hex escapes would swallow the following hex digits
+                os << '\\' << oct << setw(3) << setfill('0') << unsigned{ c } << dec;
+            }
+        }
+        os << '"';
+        return os.str();
+    }
+}
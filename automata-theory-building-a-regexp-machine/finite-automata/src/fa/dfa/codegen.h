@@ -0,0 +1,53 @@
+#ifndef FA_DFA_CODEGEN_H
+#define FA_DFA_CODEGEN_H
+
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "dfa.h"
+
+namespace fa::dfa
+{
+    /**
+     * Shape of the generated matchers.
+     *
+     * - GOTO: every DFA state becomes a label, and its transitions a few byte range comparisons
+     *   jumping (goto) straight to the next state label. No table at all, so the compiler lays out
+     *   and specializes every state on its own.
+     * - TABLE: the byte classes and transitions as `static constexpr` arrays, walked by a loop
+     *   (like Table::matches). Smaller code for big automata.
+     */
+    enum class CodeStyle { GOTO, TABLE };
+
+    /**
+     * A run of consecutive bytes moving to the same state.
+     */
+    struct ByteRun {
+        unsigned from;
+        unsigned to;
+        uint32_t target;
+    };
+
+    /**
+     * The transitions of a state, as runs of bytes in ascending order covering the whole alphabet.
+     */
+    [[nodiscard]]
+    std::vector<ByteRun> byte_runs(const Table& table, uint32_t state);
+
+    /**
+     * Writes a standalone C++ function, `inline bool name(std::string_view input) noexcept`, that
+     * verifies if the whole input matches the given table. The generated code only needs
+     * <cstdint> and <string_view>.
+     */
+    void generate_matcher(std::ostream& os, const Table& table, const std::string& name, CodeStyle style = CodeStyle::GOTO);
+
+    /**
+     * The given bytes as a C++ string literal, quotes included.
+     */
+    [[nodiscard]]
+    std::string string_literal(std::string_view bytes);
+}
+
+#endif
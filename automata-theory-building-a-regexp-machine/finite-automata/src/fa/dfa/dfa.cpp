@@ -1,48 +1,422 @@
 #include "dfa.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <limits>
+
+#include <fa/sparse_set.h>
+
+#include "mapped.h"
 
 using namespace std;
 using namespace fa;
 
 namespace fa::dfa
 {
-    Table::Table(nfa::NFA nfa)
-    {
-        // TODO this could be encapsulated inside a NFA method... need to think better about the lifetime of
-        // these objects...
-        nfa::TransitionsTableVisitor visitor;
-        nfa.accept(visitor);
-        const nfa::TransitionsTable& nfa_transitions_table = visitor.get_transitions_table();
-
-        // struct TransitionsTable {
-        //     const State* starting;
-        //     std::map<const State*, std::map<std::string, std::vector<const State*>>> table;
-        //     std::map<const State*, std::vector<const State*>> epsilon_closures;
-        // };
-        // TODO think better for the item type of this vector. We probably need some kind of dfa::State/TableItem struct.
-        //      if we have state labels here, we could concat those labels to form the string that would represent the
-        //      resulting dfa state.
-        // for every state from the nfa-transitions table, we need to keep track of new created states.
-        // we break the loop when no more states were created from this traversal.
-        vector<size_t> new_dfa_states;
-        bool done = false;
-        while (!done) {
-            for (const auto& [from_state, transitions]: nfa_transitions_table.table) {
-                // if there are no symbol-transitions from this state, the dfa resulting state is
-                // the nfa state's epsilon closure
-                if (transitions.empty()) {
-                    auto it = nfa_transitions_table.epsilon_closures.find(from_state);
-                    // every nfa-transitions table need to have a non-empty epsilon_closure starting from this state
-                    assert(it != nfa_transitions_table.epsilon_closures.end());
-                    vector<const nfa::State*> epsilon_closure_states = it->second;
-                    // TODO merge somehow the new dfa state from these nfa::states and then
-                    //      add it the the new_dfa_states vector
-                }
-                for (const auto& [symbol, next_states]: transitions) {
+    Table::Table(nfa::NFA nfa, bool anchored)
+        : Table(nfa::Automaton{ nfa }.without_epsilons(), anchored)
+    {
+    }
+
+    Table::Table(const nfa::Automaton& automaton, bool anchored)
+        : byte_classes(automaton)
+        , class_count(byte_classes.get_class_count())
+        , pattern_count(automaton.get_pattern_count())
+        , pattern_words((automaton.get_pattern_count() + 63) / 64)
+    {
+        // Every DFA state is identified by the (sorted) set of NFA states it represents.
+        using NFAStates = vector<uint32_t>;
+
+        SparseSet listed_states{ automaton.get_state_count() };
+        NFAStates stack;
+
+        // replaces the given states by their (sorted) epsilon closure
+        auto close = [&](NFAStates& states) {
+            stack = move(states);
+            states.clear();
+            while (!stack.empty()) {
+                uint32_t state = stack.back();
+                stack.pop_back();
+                if (!listed_states.insert(state)) {
+                    continue;
+                }
+                states.push_back(state);
+                for (uint32_t next_state: automaton.get_epsilon_transitions(state)) {
+                    stack.push_back(next_state);
+                }
+            }
+            listed_states.clear();
+            sort(states.begin(), states.end());
+        };
+
+        auto contains_accepting = [&automaton](const NFAStates& states) {
+            return any_of(states.begin(), states.end(), [&automaton](uint32_t s) { return automaton.is_accepting(s); });
+        };
+
+        map<NFAStates, uint32_t> dfa_states;
+        vector<const NFAStates*> pending;
+
+        auto get_or_create = [&](NFAStates& states) {
+            if (!anchored) {
+                // the implicit `.*` prefix: a match may start anywhere, so every state can start over
+                states.push_back(automaton.get_starting_state());
+            }
+            close(states);
+            auto it = dfa_states.find(states);
+            if (it != dfa_states.end()) {
+                return it->second;
+            }
+            uint32_t id = this->add_state(contains_accepting(states));
+            for (uint32_t state: states) {
+                if (automaton.is_accepting(state)) {
+                    this->add_accepted_pattern(id, automaton.get_pattern(state));
+                }
+            }
+            it = dfa_states.emplace(move(states), id).first;
+            pending.push_back(&it->first);
+            return id;
+        };
+
+        this->add_state(false);
+        assert(this->state_count - 1 == DEAD_STATE);
+
+        NFAStates starting_states{ automaton.get_starting_state() };
+        this->starting_state = get_or_create(starting_states);
+
+        vector<nfa::Automaton::Edge> edges;
+        NFAStates move_states;
+
+        // We break the loop when no more DFA states were created from this traversal.
+        while (!pending.empty()) {
+            const NFAStates& from_states = *pending.back();
+            pending.pop_back();
+            uint32_t from_id = dfa_states.at(from_states);
+
+            edges.clear();
+            for (uint32_t from_state: from_states) {
+                for (const auto& edge: automaton.get_transitions(from_state)) {
+                    edges.push_back(edge);
+                }
+            }
+
+            // all bytes of a class lead to the very same NFA states, so any of them will do
+            for (size_t byte_class = 0; byte_class < this->class_count; byte_class++) {
+                unsigned char c = this->byte_classes.get_representative(byte_class);
+
+                move_states.clear();
+                for (const auto& edge: edges) {
+                    if (edge.contains(c)) {
+                        move_states.push_back(edge.target);
+                    }
+                }
+                if (move_states.empty() && anchored) {
+                    continue;
+                }
+
+                this->transitions[from_id * this->class_count + byte_class] = get_or_create(move_states);
+            }
+        }
+
+        this->unminimized_state_count = this->state_count;
+        this->minimize();
+    }
+
+    uint32_t Table::add_state(bool is_accepting)
+    {
+        assert(this->state_count < numeric_limits<uint32_t>::max());
+        uint32_t id = static_cast<uint32_t>(this->state_count++);
+
+        // new rows start pointing to the dead state
+        this->transitions.resize(this->state_count * this->class_count, DEAD_STATE);
+        this->accepting.resize((this->state_count + 63) / 64, 0);
+        this->accepted_patterns.resize(this->state_count * this->pattern_words, 0);
+        if (is_accepting) {
+            this->accepting[id / 64] |= uint64_t{1} << (id % 64);
+        }
+
+        return id;
+    }
+
+    void Table::add_accepted_pattern(uint32_t state, uint32_t pattern)
+    {
+        assert(pattern < this->pattern_count);
+        assert(this->is_accepting(state));
+
+        this->accepted_patterns[state * this->pattern_words + pattern / 64] |= uint64_t{1} << (pattern % 64);
+    }
+
+    void Table::minimize()
+    {
+        const size_t n = this->state_count;
+        const size_t columns = this->class_count;
+
+        // Inverse transitions, grouped by symbol and then by target state (CSR layout):
+        // the predecessors of `to` reading class `c` are inverse[inverse_offsets[c * n + to] .. inverse_offsets[c * n + to + 1]]
+        vector<uint32_t> inverse_offsets(columns * n + 1, 0);
+        vector<uint32_t> inverse(columns * n);
+        for (size_t from = 0; from < n; from++) {
+            for (size_t c = 0; c < columns; c++) {
+                inverse_offsets[c * n + this->transitions[from * columns + c] + 1]++;
+            }
+        }
+        for (size_t i = 1; i < inverse_offsets.size(); i++) {
+            inverse_offsets[i] += inverse_offsets[i - 1];
+        }
+        {
+            vector<uint32_t> fill(inverse_offsets.begin(), inverse_offsets.end() - 1);
+            for (size_t from = 0; from < n; from++) {
+                for (size_t c = 0; c < columns; c++) {
+                    inverse[fill[c * n + this->transitions[from * columns + c]]++] = static_cast<uint32_t>(from);
+                }
+            }
+        }
+
+        // Refinable partition: the states of block b are elements[first[b] .. end[b]]. While splitting,
+        // the marked states of a block are moved to the front of its range.
+        vector<uint32_t> elements(n);
+        vector<uint32_t> location(n);
+        vector<uint32_t> block_of(n);
+        vector<uint32_t> first;
+        vector<uint32_t> end;
+        vector<uint32_t> marked;
+        vector<bool> in_worklist;
+        vector<uint32_t> worklist;
+
+        {
+            // initial partition: states accepting the very same patterns (non-accepting ones accept none)
+            map<vector<uint64_t>, vector<uint32_t>> initial_blocks;
+            for (uint32_t state = 0; state < n; state++) {
+                const uint64_t* patterns = this->get_accepted_patterns(state);
+                initial_blocks[vector<uint64_t>(patterns, patterns + this->pattern_words)].push_back(state);
+            }
+
+            uint32_t i = 0;
+            for (const auto& [patterns, states]: initial_blocks) {
+                first.push_back(i);
+                for (uint32_t state: states) {
+                    elements[i] = state;
+                    location[state] = i;
+                    block_of[state] = static_cast<uint32_t>(first.size() - 1);
+                    i++;
+                }
+                end.push_back(i);
+                marked.push_back(0);
+                in_worklist.push_back(true);
+                worklist.push_back(static_cast<uint32_t>(first.size() - 1));
+            }
+        }
+
+        vector<uint32_t> splitter;
+        vector<uint32_t> touched_blocks;
+        while (!worklist.empty()) {
+            uint32_t splitter_block = worklist.back();
+            worklist.pop_back();
+            in_worklist[splitter_block] = false;
+            splitter.assign(elements.begin() + first[splitter_block], elements.begin() + end[splitter_block]);
+
+            for (size_t c = 0; c < columns; c++) {
+                // mark every state that moves into the splitter reading class c
+                for (uint32_t to: splitter) {
+                    for (uint32_t i = inverse_offsets[c * n + to]; i < inverse_offsets[c * n + to + 1]; i++) {
+                        uint32_t state = inverse[i];
+                        uint32_t block = block_of[state];
+                        uint32_t marked_end = first[block] + marked[block];
+                        if (location[state] < marked_end) {
+                            continue;
+                        }
+                        uint32_t other = elements[marked_end];
+                        swap(elements[location[state]], elements[marked_end]);
+                        location[other] = location[state];
+                        location[state] = marked_end;
+                        if (marked[block]++ == 0) {
+                            touched_blocks.push_back(block);
+                        }
+                    }
+                }
 
+                // split every block that was only partially marked
+                for (uint32_t block: touched_blocks) {
+                    uint32_t marked_count = marked[block];
+                    marked[block] = 0;
+                    if (marked_count == end[block] - first[block]) {
+                        continue;
+                    }
+
+                    uint32_t new_block = static_cast<uint32_t>(first.size());
+                    first.push_back(first[block]);
+                    end.push_back(first[block] + marked_count);
+                    marked.push_back(0);
+                    first[block] += marked_count;
+                    for (uint32_t i = first[new_block]; i < end[new_block]; i++) {
+                        block_of[elements[i]] = new_block;
+                    }
+
+                    uint32_t new_size = end[new_block] - first[new_block];
+                    uint32_t old_size = end[block] - first[block];
+                    if (in_worklist[block] || new_size <= old_size) {
+                        in_worklist.push_back(true);
+                        worklist.push_back(new_block);
+                    } else {
+                        in_worklist.push_back(false);
+                        in_worklist[block] = true;
+                        worklist.push_back(block);
+                    }
                 }
+                touched_blocks.clear();
+            }
+        }
+
+        // Renumber the blocks: the dead block is still the dead state and the remaining ones are numbered in
+        // breadth-first order from the starting state, so states used together are stored close together.
+        const uint32_t unnumbered = numeric_limits<uint32_t>::max();
+        vector<uint32_t> block_ids(first.size(), unnumbered);
+        vector<uint32_t> representatives;
+        block_ids[block_of[DEAD_STATE]] = DEAD_STATE;
+        representatives.push_back(DEAD_STATE);
+
+        if (block_ids[block_of[this->starting_state]] == unnumbered) {
+            block_ids[block_of[this->starting_state]] = static_cast<uint32_t>(representatives.size());
+            representatives.push_back(this->starting_state);
+        }
+        for (size_t i = 0; i < representatives.size(); i++) {
+            uint32_t from = representatives[i];
+            for (size_t c = 0; c < columns; c++) {
+                uint32_t to_block = block_of[this->transitions[from * columns + c]];
+                if (block_ids[to_block] == unnumbered) {
+                    block_ids[to_block] = static_cast<uint32_t>(representatives.size());
+                    representatives.push_back(elements[first[to_block]]);
+                }
+            }
+        }
+
+        vector<uint32_t> old_transitions = move(this->transitions);
+        vector<uint64_t> old_accepting = move(this->accepting);
+        vector<uint64_t> old_accepted_patterns = move(this->accepted_patterns);
+        uint32_t old_starting_state = this->starting_state;
+
+        this->transitions.clear();
+        this->accepting.clear();
+        this->accepted_patterns.clear();
+        this->state_count = 0;
+        for (uint32_t representative: representatives) {
+            uint32_t id = this->add_state((old_accepting[representative / 64] >> (representative % 64)) & 1);
+            copy_n(
+                old_accepted_patterns.begin() + representative * this->pattern_words,
+                this->pattern_words,
+                this->accepted_patterns.begin() + id * this->pattern_words
+            );
+            for (size_t c = 0; c < columns; c++) {
+                uint32_t to = old_transitions[representative * columns + c];
+                this->transitions[id * columns + c] = block_ids[block_of[to]];
+            }
+        }
+        this->starting_state = block_ids[block_of[old_starting_state]];
+    }
+
+    bool Table::matches(string_view input) const
+    {
+        uint32_t state = this->starting_state;
+        for (unsigned char c: input) {
+            state = this->next(state, c);
+            if (state == DEAD_STATE) {
+                return false;
+            }
+        }
+
+        return this->is_accepting(state);
+    }
+
+    optional<size_t> Table::longest_match(string_view input) const
+    {
+        uint32_t state = this->starting_state;
+        optional<size_t> longest;
+        if (this->is_accepting(state)) {
+            longest = 0;
+        }
+
+        for (size_t i = 0; i < input.size(); i++) {
+            state = this->next(state, static_cast<unsigned char>(input[i]));
+            if (state == DEAD_STATE) {
+                break;
+            }
+            if (this->is_accepting(state)) {
+                longest = i + 1;
             }
         }
+
+        return longest;
+    }
+
+    string Table::serialize() const
+    {
+        auto align = [](size_t offset) { return (offset + 7) / 8 * 8; };
+
+        TableHeader header{};
+        copy_n(TableHeader::MAGIC, sizeof(TableHeader::MAGIC), header.magic);
+        header.version = TableHeader::VERSION;
+        header.byte_order = TableHeader::BYTE_ORDER_MARK;
+        header.class_count = static_cast<uint32_t>(this->class_count);
+        header.state_count = static_cast<uint32_t>(this->state_count);
+        header.starting_state = this->starting_state;
+        header.pattern_count = static_cast<uint32_t>(this->pattern_count);
+        header.pattern_words = static_cast<uint32_t>(this->pattern_words);
+        header.classes_offset = sizeof(TableHeader);
+        header.transitions_offset = align(header.classes_offset + ByteClasses::ALPHABET_SIZE);
+        header.accepting_offset = align(header.transitions_offset + this->transitions.size() * sizeof(uint32_t));
+        header.accepted_patterns_offset = header.accepting_offset + this->accepting.size() * sizeof(uint64_t);
+        header.size = header.accepted_patterns_offset + this->accepted_patterns.size() * sizeof(uint64_t);
+
+        string data(header.size, '\0');
+        const auto& classes = this->byte_classes.get_classes();
+        memcpy(data.data() + header.classes_offset, classes.data(), classes.size());
+        memcpy(data.data() + header.transitions_offset, this->transitions.data(), this->transitions.size() * sizeof(uint32_t));
+        memcpy(data.data() + header.accepting_offset, this->accepting.data(), this->accepting.size() * sizeof(uint64_t));
+        memcpy(
+            data.data() + header.accepted_patterns_offset,
+            this->accepted_patterns.data(),
+            this->accepted_patterns.size() * sizeof(uint64_t)
+        );
+
+        header.checksum = fnv1a(data.data() + sizeof(TableHeader), data.size() - sizeof(TableHeader));
+        memcpy(data.data(), &header, sizeof(TableHeader));
+
+        return data;
+    }
+
+    void Table::save(ostream& os) const
+    {
+        string data = this->serialize();
+        os.write(data.data(), static_cast<streamsize>(data.size()));
+    }
+
+    uint32_t Table::get_starting_state() const
+    {
+        return this->starting_state;
+    }
+
+    size_t Table::get_state_count() const
+    {
+        return this->state_count;
+    }
+
+    const ByteClasses& Table::get_byte_classes() const
+    {
+        return this->byte_classes;
+    }
+
+    size_t Table::get_pattern_count() const
+    {
+        return this->pattern_count;
+    }
+
+    size_t Table::get_pattern_words() const
+    {
+        return this->pattern_words;
+    }
+
+    size_t Table::get_unminimized_state_count() const
+    {
+        return this->unminimized_state_count;
     }
 }
@@ -1,20 +1,156 @@
 #ifndef FA_DFA_H
 #define FA_DFA_H
 
+#include <cstdint>
 #include <map>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
 #include <vector>
 
+#include <fa/nfa/automaton.h>
 #include <fa/nfa/nfa.h>
 
+#include "byte_classes.h"
+
 namespace fa::dfa
 {
+    /**
+     * DFA Transitions Table.
+     *
+     * A Deterministic Finite Automata built from a NFA through the subset construction.
+     * Every DFA state represents a set of NFA states (the union of their epsilon closures).
+     *
+     * The machine is stored as a flat table of `state_count * class_count` entries (one column
+     * per byte equivalence class) plus a bitmap of the accepting states, so matching is a single
+     * table lookup per input byte (after mapping it to its class) and never allocates.
+     *
+     * A DFA built from several patterns (see nfa::Automaton) also keeps, for every state, the
+     * bitset of patterns it accepts.
+     *
+     * After the subset construction, the table is minimized (Hopcroft's partition refinement), merging
+     * all equivalent states. The smaller the table, the more of it stays in the CPU caches while matching.
+     */
     class Table
     {
+    public:
+        /**
+         * The dead (trap) state. It is never accepting and all its transitions loop back to itself.
+         */
+        static constexpr uint32_t DEAD_STATE = 0;
+
     protected:
-        // TODO define the dfa State structure
+        ByteClasses byte_classes;
+        // number of columns of each table row (one per byte class)
+        size_t class_count;
+        uint32_t starting_state = DEAD_STATE;
+        size_t state_count = 0;
+        size_t unminimized_state_count = 0;
+        size_t pattern_count = 1;
+        // number of 64 bits words of each accepted patterns bitset
+        size_t pattern_words = 1;
+        std::vector<uint32_t> transitions;
+        std::vector<uint64_t> accepting;
+        std::vector<uint64_t> accepted_patterns;
+
+        uint32_t add_state(bool is_accepting);
+
+        void add_accepted_pattern(uint32_t state, uint32_t pattern);
+
+        /**
+         * Hopcroft's DFA minimization.
+         *
+         * Starting from the partition of states by the patterns they accept, blocks of states are split until all
+         * states of every block agree, for every byte class, on the block they move to. Each resulting
+         * block becomes a single state. States equivalent to the dead state are merged into it.
+         */
+        void minimize();
 
     public:
-        Table(fa::nfa::NFA nfa);
+        /**
+         * Builds the DFA for the given NFA.
+         *
+         * An unanchored DFA recognizes every input that ends with a match of the NFA, as if
+         * the NFA was prefixed by `.*`.
+         */
+        Table(fa::nfa::NFA nfa, bool anchored = true);
+
+        Table(const fa::nfa::Automaton& automaton, bool anchored = true);
+
+        /**
+         * Verifies if the whole given input matches this DFA.
+         */
+        [[nodiscard]]
+        bool matches(std::string_view input) const;
+
+        /**
+         * Length of the longest prefix of the input matching this DFA, if any.
+         */
+        [[nodiscard]]
+        std::optional<size_t> longest_match(std::string_view input) const;
+
+        /**
+         * Serializes this table in a flat, position independent and checksummed binary format (see
+         * TableHeader), that a TableView (or a MappedTable) matches on without any copy.
+         */
+        [[nodiscard]]
+        std::string serialize() const;
+
+        /**
+         * Writes the serialized table (see serialize()) to the given stream.
+         */
+        void save(std::ostream& os) const;
+
+        [[nodiscard]]
+        uint32_t next(uint32_t state, unsigned char c) const
+        {
+            return this->transitions[state * this->class_count + this->byte_classes.get(c)];
+        }
+
+        [[nodiscard]]
+        bool is_accepting(uint32_t state) const
+        {
+            return (this->accepting[state / 64] >> (state % 64)) & 1;
+        }
+
+        /**
+         * Bitset (pattern_words long) of the patterns accepted at the given state.
+         */
+        [[nodiscard]]
+        const uint64_t* get_accepted_patterns(uint32_t state) const
+        {
+            return this->accepted_patterns.data() + state * this->pattern_words;
+        }
+
+        [[nodiscard]]
+        bool accepts_pattern(uint32_t state, size_t pattern) const
+        {
+            return (this->get_accepted_patterns(state)[pattern / 64] >> (pattern % 64)) & 1;
+        }
+
+        // GETTERS
+
+        [[nodiscard]]
+        uint32_t get_starting_state() const;
+
+        [[nodiscard]]
+        size_t get_state_count() const;
+
+        [[nodiscard]]
+        const ByteClasses& get_byte_classes() const;
+
+        [[nodiscard]]
+        size_t get_pattern_count() const;
+
+        [[nodiscard]]
+        size_t get_pattern_words() const;
+
+        /**
+         * Number of states resulting from the subset construction, before minimization.
+         */
+        [[nodiscard]]
+        size_t get_unminimized_state_count() const;
     };
 }
 
@@ -0,0 +1,292 @@
+#include "jit.h"
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#if defined(FA_JIT) && defined(__x86_64__) && defined(__unix__)
+#define FA_JIT_X86_64
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "codegen.h"
+
+using namespace std;
+
+namespace fa::dfa
+{
+#ifdef FA_JIT_X86_64
+    /**
+     * Above this many byte runs, a state dispatches through a jump table rather than comparisons.
+     */
+    static constexpr size_t MAX_COMPARISONS = 8;
+
+    /**
+     * x86-64 machine code buffer, with rel32 jumps to labels resolved once all are placed.
+     *
+     * Registers of the generated code (System V calling convention):
+     * - rdi: the current input byte pointer, rsi: the end of the input, rdx: its start
+     * - rax: the longest match length so far (-1 if none), rcx: the current byte
+     */
+    class Assembler
+    {
+    protected:
+        struct Fixup {
+            size_t offset;
+            uint32_t label;
+        };
+
+        vector<Fixup> fixups;
+        // offsets of the jump table entries to relocate by the final code address
+        vector<size_t> absolute_fixups;
+
+    public:
+        vector<unsigned char> code;
+        vector<size_t> labels;
+
+        explicit Assembler(size_t label_count)
+            : labels(label_count, 0)
+        {
+        }
+
+        void emit(initializer_list<unsigned char> bytes)
+        {
+            this->code.insert(this->code.end(), bytes);
+        }
+
+        void emit32(uint32_t value)
+        {
+            for (size_t i = 0; i < 4; i++) {
+                this->code.push_back(static_cast<unsigned char>(value >> (8 * i)));
+            }
+        }
+
+        void place(uint32_t label)
+        {
+            this->labels[label] = this->code.size();
+        }
+
+        void rel32(uint32_t label)
+        {
+            this->fixups.push_back(Fixup{ this->code.size(), label });
+            this->emit32(0);
+        }
+
+        void jmp(uint32_t label)
+        {
+            this->emit({ 0xe9 });
+            this->rel32(label);
+        }
+
+        // conditional jump (0x0f 0x80+cc) with a rel32 displacement
+        void jcc(unsigned char condition, uint32_t label)
+        {
+            this->emit({ 0x0f, condition });
+            this->rel32(label);
+        }
+
+        void address64(uint32_t label)
+        {
+            this->absolute_fixups.push_back(this->code.size());
+            this->emit32(label);
+            this->emit32(0);
+        }
+
+        void align(size_t alignment)
+        {
+            while (this->code.size() % alignment != 0) {
+                this->emit({ 0xcc });
+            }
+        }
+
+        void link(unsigned char* destination) const
+        {
+            memcpy(destination, this->code.data(), this->code.size());
+            for (const Fixup& fixup: this->fixups) {
+                auto displacement = static_cast<int32_t>(this->labels[fixup.label] - (fixup.offset + 4));
+                memcpy(destination + fixup.offset, &displacement, sizeof(displacement));
+            }
+            for (size_t offset: this->absolute_fixups) {
+                uint32_t label;
+                memcpy(&label, destination + offset, sizeof(label));
+                uint64_t address = reinterpret_cast<uint64_t>(destination) + this->labels[label];
+                memcpy(destination + offset, &address, sizeof(address));
+            }
+        }
+    };
+
+    static constexpr unsigned char JAE = 0x83;
+    static constexpr unsigned char JBE = 0x86;
+
+    void Jit::compile()
+    {
+        // a label per state, the dead state one returning
+        const uint32_t state_count = static_cast<uint32_t>(this->table.get_state_count());
+        const uint32_t done = Table::DEAD_STATE;
+        Assembler assembler{ state_count };
+        vector<pair<uint32_t, vector<ByteRun>>> jump_tables;
+
+        assembler.emit({ 0x48, 0x89, 0xfa });                   // mov rdx, rdi
+        assembler.emit({ 0x48, 0x01, 0xfe });                   // add rsi, rdi
+        assembler.emit({ 0x48, 0xc7, 0xc0, 0xff, 0xff, 0xff, 0xff }); // mov rax, -1
+        assembler.jmp(this->table.get_starting_state());
+
+        assembler.place(done);
+        assembler.emit({ 0xc3 });                               // ret
+
+        for (uint32_t state = 0; state < state_count; state++) {
+            if (state == Table::DEAD_STATE) {
+                continue;
+            }
+            assembler.align(16);
+            assembler.place(state);
+            if (this->table.is_accepting(state)) {
+                assembler.emit({ 0x48, 0x89, 0xf8 });           // mov rax, rdi
+                assembler.emit({ 0x48, 0x29, 0xd0 });           // sub rax, rdx
+            }
+
+            vector<ByteRun> runs = byte_runs(this->table, state);
+            if (runs.size() == 1 && runs[0].target == Table::DEAD_STATE) {
+                assembler.emit({ 0xc3 });                       // ret
+                continue;
+            }
+            assembler.emit({ 0x48, 0x39, 0xf7 });               // cmp rdi, rsi
+            assembler.jcc(JAE, done);
+            assembler.emit({ 0x0f, 0xb6, 0x0f });               // movzx ecx, byte [rdi]
+            assembler.emit({ 0x48, 0x83, 0xc7, 0x01 });         // add rdi, 1
+
+            if (runs.size() > MAX_COMPARISONS) {
+                // the table label is placed after all states
+                uint32_t table_label = static_cast<uint32_t>(assembler.labels.size());
+                assembler.labels.push_back(0);
+                assembler.emit({ 0x4c, 0x8d, 0x05 });           // lea r8, [rip + table]
+                assembler.rel32(table_label);
+                assembler.emit({ 0x41, 0xff, 0x24, 0xc8 });     // jmp [r8 + rcx * 8]
+                jump_tables.emplace_back(table_label, move(runs));
+                continue;
+            }
+            for (size_t i = 0; i + 1 < runs.size(); i++) {
+                assembler.emit({ 0x81, 0xf9 });                 // cmp ecx, imm32
+                assembler.emit32(runs[i].to);
+                assembler.jcc(JBE, runs[i].target);
+            }
+            assembler.jmp(runs.back().target);
+        }
+
+        for (const auto& [label, runs]: jump_tables) {
+            assembler.align(8);
+            assembler.place(label);
+            for (const ByteRun& run: runs) {
+                for (unsigned c = run.from; c <= run.to; c++) {
+                    assembler.address64(run.target);
+                }
+            }
+        }
+
+        const auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        const size_t size = (assembler.code.size() + page_size - 1) / page_size * page_size;
+        void* pages = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (pages == MAP_FAILED) {
+            return;
+        }
+        assembler.link(static_cast<unsigned char*>(pages));
+        if (mprotect(pages, size, PROT_READ | PROT_EXEC) != 0) {
+            munmap(pages, size);
+            return;
+        }
+        this->code = pages;
+        this->code_size = size;
+    }
+
+    bool Jit::is_supported()
+    {
+        return true;
+    }
+#else
+    void Jit::compile()
+    {
+    }
+
+    bool Jit::is_supported()
+    {
+        return false;
+    }
+#endif
+
+    Jit::Jit(Table table)
+        : table(move(table))
+    {
+        this->compile();
+    }
+
+    Jit::Jit(Jit&& other) noexcept
+        : table(move(other.table))
+        , code(exchange(other.code, nullptr))
+        , code_size(exchange(other.code_size, 0))
+    {
+    }
+
+    Jit& Jit::operator=(Jit&& other) noexcept
+    {
+        if (this != &other) {
+#ifdef FA_JIT_X86_64
+            if (this->code) {
+                munmap(this->code, this->code_size);
+            }
+#endif
+            this->table = move(other.table);
+            this->code = exchange(other.code, nullptr);
+            this->code_size = exchange(other.code_size, 0);
+        }
+        return *this;
+    }
+
+    Jit::~Jit()
+    {
+#ifdef FA_JIT_X86_64
+        if (this->code) {
+            munmap(this->code, this->code_size);
+        }
+#endif
+    }
+
+    bool Jit::matches(string_view input) const
+    {
+        if (!this->code) {
+            return this->table.matches(input);
+        }
+        // the longest match spans the whole input only if it matches
+        auto function = reinterpret_cast<Function>(this->code);
+        int64_t length = function(reinterpret_cast<const unsigned char*>(input.data()), input.size());
+        return length >= 0 && static_cast<size_t>(length) == input.size();
+    }
+
+    optional<size_t> Jit::longest_match(string_view input) const
+    {
+        if (!this->code) {
+            return this->table.longest_match(input);
+        }
+        auto function = reinterpret_cast<Function>(this->code);
+        int64_t length = function(reinterpret_cast<const unsigned char*>(input.data()), input.size());
+        if (length < 0) {
+            return nullopt;
+        }
+        return static_cast<size_t>(length);
+    }
+
+    bool Jit::is_compiled() const
+    {
+        return this->code != nullptr;
+    }
+
+    size_t Jit::get_code_size() const
+    {
+        return this->code_size;
+    }
+
+    const Table& Jit::get_table() const
+    {
+        return this->table;
+    }
+}
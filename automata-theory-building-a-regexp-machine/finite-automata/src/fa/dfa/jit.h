@@ -0,0 +1,92 @@
+#ifndef FA_DFA_JIT_H
+#define FA_DFA_JIT_H
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "dfa.h"
+
+namespace fa::dfa
+{
+    /**
+     * Native (x86-64) code for a DFA Table.
+     *
+     * Every state becomes a block of machine code: record the match length if accepting, stop at
+     * the end of the input, load the next byte and jump straight to the next state block, through
+     * a chain of byte range comparisons, or through a jump table when the state has many ranges.
+     * No byte class nor transitions lookup is left, so nothing but the input load sits on the
+     * critical path of every byte.
+     *
+     * That only pays off while those branches are predictable, as when most bytes of the input
+     * keep taking the same run of each state (literals, digit runs, `.*` tails): matching log
+     * lines with `ERROR [0-9]+: .*` is about 4x faster than Table::longest_match. On a dense DFA
+     * fed unpredictable bytes, almost every byte mispredicts its jump, and the JIT is slower than
+     * the table (about 0.6x for `(a|b)*a(a|b)(a|b)(a|b)` over random a/b input). Jump tables
+     * don't help there, as their indirect jumps mispredict just as often. Measure both on the
+     * real inputs (see fa-benchmark) before picking the JIT.
+     *
+     * The code is written to mmap'd pages, which are made executable (and read only) once complete.
+     *
+     * The JIT is only built on x86-64 POSIX hosts, when the FA_JIT macro is defined (the `jit` meson
+     * option). Elsewhere, or if the pages can't be mapped, it falls back to walking the table.
+     */
+    class Jit
+    {
+    protected:
+        // signature of the generated code: the longest match length, or -1 if none
+        using Function = int64_t (*)(const unsigned char* input, size_t size);
+
+        Table table;
+        void* code = nullptr;
+        size_t code_size = 0;
+
+        void compile();
+
+    public:
+        explicit Jit(Table table);
+
+        Jit(const Jit&) = delete;
+        Jit& operator=(const Jit&) = delete;
+        Jit(Jit&& other) noexcept;
+        Jit& operator=(Jit&& other) noexcept;
+        ~Jit();
+
+        /**
+         * Whether native code can be generated in this build.
+         */
+        [[nodiscard]]
+        static bool is_supported();
+
+        /**
+         * Verifies if the whole given input matches the DFA.
+         */
+        [[nodiscard]]
+        bool matches(std::string_view input) const;
+
+        /**
+         * Length of the longest prefix of the input matching the DFA, if any.
+         */
+        [[nodiscard]]
+        std::optional<size_t> longest_match(std::string_view input) const;
+
+        // GETTERS
+
+        /**
+         * Whether native code was generated (otherwise the table is interpreted).
+         */
+        [[nodiscard]]
+        bool is_compiled() const;
+
+        /**
+         * Size of the mapped code pages (0 if not compiled).
+         */
+        [[nodiscard]]
+        size_t get_code_size() const;
+
+        [[nodiscard]]
+        const Table& get_table() const;
+    };
+}
+
+#endif
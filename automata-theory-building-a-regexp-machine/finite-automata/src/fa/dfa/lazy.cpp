@@ -0,0 +1,183 @@
+#include "lazy.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+using namespace fa;
+
+namespace fa::dfa
+{
+    LazyDFA::LazyDFA(nfa::NFA nfa, size_t memory_budget)
+        : automaton(nfa::Automaton{ nfa }.without_epsilons())
+        , simulator(this->automaton)
+        , byte_classes(this->automaton)
+        , class_count(this->byte_classes.get_class_count())
+        , memory_budget(memory_budget)
+        , listed_states(this->automaton.get_state_count())
+    {
+        this->flush();
+        this->flush_count = 0;
+    }
+
+    size_t LazyDFA::state_cost(const NFAStates& states) const
+    {
+        // transitions row + cache key + (roughly) the cache node itself
+        return this->class_count * sizeof(uint32_t)
+            + states.size() * sizeof(uint32_t)
+            + sizeof(NFAStates) + 4 * sizeof(void*);
+    }
+
+    void LazyDFA::flush()
+    {
+        this->cache.clear();
+        this->state_sets.clear();
+        this->transitions.clear();
+        this->accepting.clear();
+        this->memory_used = 0;
+        this->flush_count++;
+
+        // the dead and the starting states are always cached, whatever the budget is
+        uint32_t dead_state = this->add_state({});
+        assert(dead_state == DEAD_STATE);
+        (void) dead_state;
+
+        this->move_states.assign({ this->automaton.get_starting_state() });
+        this->close_move_states();
+        this->starting_state = this->add_state(this->move_states);
+        if (this->starting_state == UNKNOWN_STATE) {
+            // budget is too small even for the starting state. force it in anyway
+            size_t memory_budget = this->memory_budget;
+            this->memory_budget = numeric_limits<size_t>::max();
+            this->starting_state = this->add_state(this->move_states);
+            this->memory_budget = memory_budget;
+        }
+    }
+
+    void LazyDFA::close_move_states()
+    {
+        this->stack = move(this->move_states);
+        this->move_states.clear();
+
+        while (!this->stack.empty()) {
+            uint32_t state = this->stack.back();
+            this->stack.pop_back();
+
+            if (!this->listed_states.insert(state)) {
+                continue;
+            }
+            this->move_states.push_back(state);
+
+            for (uint32_t next_state: this->automaton.get_epsilon_transitions(state)) {
+                this->stack.push_back(next_state);
+            }
+        }
+        this->listed_states.clear();
+        sort(this->move_states.begin(), this->move_states.end());
+    }
+
+    uint32_t LazyDFA::add_state(const NFAStates& states)
+    {
+        if (auto it = this->cache.find(states); it != this->cache.end()) {
+            return it->second;
+        }
+
+        size_t cost = state_cost(states);
+        if (this->memory_used + cost > this->memory_budget && !this->cache.empty()) {
+            return UNKNOWN_STATE;
+        }
+        this->memory_used += cost;
+
+        uint32_t id = static_cast<uint32_t>(this->state_sets.size());
+        auto [it, inserted] = this->cache.emplace(states, id);
+        assert(inserted);
+        (void) inserted;
+
+        this->state_sets.push_back(&it->first);
+        // the dead state loops on itself. every other transition is computed on demand
+        this->transitions.resize(this->transitions.size() + this->class_count, id == DEAD_STATE ? DEAD_STATE : UNKNOWN_STATE);
+        this->accepting.push_back(
+            any_of(states.begin(), states.end(), [this](uint32_t s) { return this->automaton.is_accepting(s); })
+        );
+
+        return id;
+    }
+
+    uint32_t LazyDFA::compute_next(uint32_t state, uint8_t byte_class)
+    {
+        unsigned char c = this->byte_classes.get_representative(byte_class);
+
+        this->move_states.clear();
+        for (uint32_t nfa_state: *this->state_sets[state]) {
+            for (const auto& edge: this->automaton.get_transitions(nfa_state)) {
+                if (edge.contains(c)) {
+                    this->move_states.push_back(edge.target);
+                }
+            }
+        }
+        this->close_move_states();
+
+        uint32_t next = this->add_state(this->move_states);
+        if (next != UNKNOWN_STATE) {
+            this->transitions[state * this->class_count + byte_class] = next;
+        }
+
+        return next;
+    }
+
+    bool LazyDFA::matches(string_view input)
+    {
+        size_t flushes = 0;
+        uint32_t state = this->starting_state;
+
+        for (unsigned char c: input) {
+            uint8_t byte_class = this->byte_classes.get(c);
+            uint32_t next = this->transitions[state * this->class_count + byte_class];
+            if (next == UNKNOWN_STATE) {
+                next = this->compute_next(state, byte_class);
+            }
+            if (next == UNKNOWN_STATE) {
+                // out of budget. flush the cache, keeping only where we are right now, and try again
+                if (++flushes > MAX_FLUSHES_PER_MATCH) {
+                    this->fallback_count++;
+                    return this->simulator.matches(input);
+                }
+                NFAStates current_states = *this->state_sets[state];
+                this->flush();
+                state = this->add_state(current_states);
+                next = (state == UNKNOWN_STATE) ? UNKNOWN_STATE : this->compute_next(state, byte_class);
+                if (next == UNKNOWN_STATE) {
+                    this->fallback_count++;
+                    return this->simulator.matches(input);
+                }
+            }
+
+            state = next;
+            if (state == DEAD_STATE) {
+                return false;
+            }
+        }
+
+        return this->accepting[state];
+    }
+
+    size_t LazyDFA::get_state_count() const
+    {
+        return this->state_sets.size();
+    }
+
+    size_t LazyDFA::get_memory_used() const
+    {
+        return this->memory_used;
+    }
+
+    size_t LazyDFA::get_flush_count() const
+    {
+        return this->flush_count;
+    }
+
+    size_t LazyDFA::get_fallback_count() const
+    {
+        return this->fallback_count;
+    }
+}
@@ -0,0 +1,126 @@
+#ifndef FA_DFA_LAZY_H
+#define FA_DFA_LAZY_H
+
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <string_view>
+#include <vector>
+
+#include <fa/nfa/automaton.h>
+#include <fa/nfa/nfa.h>
+#include <fa/nfa/simulator.h>
+#include <fa/sparse_set.h>
+
+#include "byte_classes.h"
+
+namespace fa::dfa
+{
+    /**
+     * Lazy (on-demand) DFA.
+     *
+     * Instead of building the whole DFA up front (which may be exponential on the NFA size, like in
+     * `(a|b)*a(a|b){20}`), DFA states and their transitions are only created when some input reaches
+     * them. Created states are kept in a cache bounded by a memory budget.
+     *
+     * When the budget is exceeded the cache is flushed and rebuilt from the current state. If that
+     * happens too often during a single match, the DFA gives up and falls back to the NFA Simulator.
+     */
+    class LazyDFA
+    {
+    public:
+        static constexpr size_t DEFAULT_MEMORY_BUDGET = 1 << 20;
+
+        /**
+         * How many times the cache may be flushed during a single match before falling back to the
+         * NFA Simulator.
+         */
+        static constexpr size_t MAX_FLUSHES_PER_MATCH = 3;
+
+    protected:
+        using NFAStates = std::vector<uint32_t>;
+
+        static constexpr uint32_t DEAD_STATE = 0;
+        static constexpr uint32_t UNKNOWN_STATE = std::numeric_limits<uint32_t>::max();
+
+        fa::nfa::Automaton automaton;
+        fa::nfa::Simulator simulator;
+        ByteClasses byte_classes;
+        // number of columns of each transitions row (one per byte class)
+        size_t class_count;
+
+        size_t memory_budget;
+        size_t memory_used = 0;
+        size_t flush_count = 0;
+        size_t fallback_count = 0;
+
+        uint32_t starting_state = DEAD_STATE;
+        std::map<NFAStates, uint32_t> cache;
+        std::vector<const NFAStates*> state_sets;
+        std::vector<uint32_t> transitions;
+        std::vector<bool> accepting;
+
+        // scratch space for computing new states
+        NFAStates move_states;
+        NFAStates stack;
+        fa::SparseSet listed_states;
+
+        /**
+         * Estimated memory used by a cached DFA state representing the given NFA states.
+         */
+        [[nodiscard]]
+        size_t state_cost(const NFAStates& states) const;
+
+        /**
+         * Drops every cached state and recreates the dead and starting states.
+         */
+        void flush();
+
+        /**
+         * Replaces the move_states scratch by its (sorted) epsilon closure.
+         */
+        void close_move_states();
+
+        /**
+         * Finds or caches the DFA state for the given NFA states.
+         *
+         * Returns UNKNOWN_STATE if the state is not cached and it does not fit the memory budget.
+         */
+        uint32_t add_state(const NFAStates& states);
+
+        /**
+         * Computes (and caches) the transition from the given state reading the given byte class.
+         *
+         * Returns UNKNOWN_STATE if the target state does not fit the memory budget.
+         */
+        uint32_t compute_next(uint32_t state, uint8_t byte_class);
+
+    public:
+        LazyDFA(fa::nfa::NFA nfa, size_t memory_budget = DEFAULT_MEMORY_BUDGET);
+
+        /**
+         * Verifies if the whole given input matches this DFA.
+         */
+        [[nodiscard]]
+        bool matches(std::string_view input);
+
+        // GETTERS
+
+        /**
+         * Number of currently cached DFA states.
+         */
+        [[nodiscard]]
+        size_t get_state_count() const;
+
+        [[nodiscard]]
+        size_t get_memory_used() const;
+
+        [[nodiscard]]
+        size_t get_flush_count() const;
+
+        [[nodiscard]]
+        size_t get_fallback_count() const;
+    };
+}
+
+#endif
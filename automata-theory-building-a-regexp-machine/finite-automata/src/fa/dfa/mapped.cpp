@@ -0,0 +1,229 @@
+#include "mapped.h"
+
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace fa::dfa
+{
+    uint64_t fnv1a(const void* data, size_t size)
+    {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        uint64_t hash = 0xcbf29ce484222325;
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3;
+        }
+        return hash;
+    }
+
+    /**
+     * Verifies that a section of count items of the given size lies (aligned) inside the data.
+     */
+    static void check_section(const TableHeader& header, uint64_t offset, uint64_t count, size_t item_size)
+    {
+        bool valid = offset % 8 == 0
+            && offset >= sizeof(TableHeader)
+            && offset <= header.size
+            && count <= (header.size - offset) / item_size;
+        if (!valid) {
+            throw FormatError{ "table section out of bounds" };
+        }
+    }
+
+    TableView::TableView(const void* data, size_t size, bool verify)
+    {
+        if (reinterpret_cast<uintptr_t>(data) % 8 != 0) {
+            throw FormatError{ "table data is not 8 bytes aligned" };
+        }
+        if (size < sizeof(TableHeader)) {
+            throw FormatError{ "truncated table header" };
+        }
+
+        const auto* header = static_cast<const TableHeader*>(data);
+        if (memcmp(header->magic, TableHeader::MAGIC, sizeof(TableHeader::MAGIC)) != 0) {
+            throw FormatError{ "not a serialized table" };
+        }
+        if (header->version != TableHeader::VERSION) {
+            throw FormatError{ "unsupported table version " + to_string(header->version) };
+        }
+        if (header->byte_order != TableHeader::BYTE_ORDER_MARK) {
+            throw FormatError{ "table saved with another byte order" };
+        }
+        if (header->size != size) {
+            throw FormatError{ "table size mismatch" };
+        }
+
+        this->class_count = header->class_count;
+        this->state_count = header->state_count;
+        this->pattern_count = header->pattern_count;
+        this->pattern_words = header->pattern_words;
+        this->starting_state = header->starting_state;
+        bool valid = this->class_count >= 1 && this->class_count <= 256
+            && this->state_count >= 1
+            && this->starting_state < this->state_count
+            && this->pattern_words == (this->pattern_count + 63) / 64;
+        if (!valid) {
+            throw FormatError{ "invalid table dimensions" };
+        }
+
+        check_section(*header, header->classes_offset, 256, 1);
+        check_section(*header, header->transitions_offset, uint64_t{ header->state_count } * header->class_count, sizeof(uint32_t));
+        check_section(*header, header->accepting_offset, (uint64_t{ header->state_count } + 63) / 64, sizeof(uint64_t));
+        check_section(*header, header->accepted_patterns_offset, uint64_t{ header->state_count } * header->pattern_words, sizeof(uint64_t));
+
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        this->classes = bytes + header->classes_offset;
+        this->transitions = reinterpret_cast<const uint32_t*>(bytes + header->transitions_offset);
+        this->accepting = reinterpret_cast<const uint64_t*>(bytes + header->accepting_offset);
+        this->accepted_patterns = reinterpret_cast<const uint64_t*>(bytes + header->accepted_patterns_offset);
+
+        if (!verify) {
+            return;
+        }
+        if (fnv1a(bytes + sizeof(TableHeader), size - sizeof(TableHeader)) != header->checksum) {
+            throw FormatError{ "table checksum mismatch" };
+        }
+        for (size_t c = 0; c < 256; c++) {
+            if (this->classes[c] >= this->class_count) {
+                throw FormatError{ "invalid byte class" };
+            }
+        }
+        for (size_t i = 0; i < this->state_count * this->class_count; i++) {
+            if (this->transitions[i] >= this->state_count) {
+                throw FormatError{ "invalid transition target" };
+            }
+        }
+    }
+
+    bool TableView::matches(string_view input) const
+    {
+        uint32_t state = this->starting_state;
+        for (unsigned char c: input) {
+            state = this->next(state, c);
+            // the dead state (Table::DEAD_STATE) is always the first one
+            if (state == 0) {
+                return false;
+            }
+        }
+
+        return this->is_accepting(state);
+    }
+
+    optional<size_t> TableView::longest_match(string_view input) const
+    {
+        uint32_t state = this->starting_state;
+        optional<size_t> longest;
+        if (this->is_accepting(state)) {
+            longest = 0;
+        }
+
+        for (size_t i = 0; i < input.size(); i++) {
+            state = this->next(state, static_cast<unsigned char>(input[i]));
+            if (state == 0) {
+                break;
+            }
+            if (this->is_accepting(state)) {
+                longest = i + 1;
+            }
+        }
+
+        return longest;
+    }
+
+    uint32_t TableView::get_starting_state() const
+    {
+        return this->starting_state;
+    }
+
+    size_t TableView::get_state_count() const
+    {
+        return this->state_count;
+    }
+
+    size_t TableView::get_class_count() const
+    {
+        return this->class_count;
+    }
+
+    size_t TableView::get_pattern_count() const
+    {
+        return this->pattern_count;
+    }
+
+    size_t TableView::get_pattern_words() const
+    {
+        return this->pattern_words;
+    }
+
+    MappedTable::MappedTable(const string& path, bool verify)
+    {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw system_error{ errno, generic_category(), path };
+        }
+
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) != 0) {
+            int error = errno;
+            close(fd);
+            throw system_error{ error, generic_category(), path };
+        }
+        this->mapping_size = static_cast<size_t>(file_stat.st_size);
+        if (this->mapping_size < sizeof(TableHeader)) {
+            close(fd);
+            throw FormatError{ "truncated table header" };
+        }
+
+        // the mapping keeps its own reference to the file
+        this->mapping = mmap(nullptr, this->mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+        int error = errno;
+        close(fd);
+        if (this->mapping == MAP_FAILED) {
+            this->mapping = nullptr;
+            throw system_error{ error, generic_category(), path };
+        }
+
+        try {
+            static_cast<TableView&>(*this) = TableView{ this->mapping, this->mapping_size, verify };
+        } catch (...) {
+            munmap(this->mapping, this->mapping_size);
+            throw;
+        }
+    }
+
+    MappedTable::MappedTable(MappedTable&& other) noexcept
+        : TableView(other)
+        , mapping(exchange(other.mapping, nullptr))
+        , mapping_size(exchange(other.mapping_size, 0))
+    {
+    }
+
+    MappedTable& MappedTable::operator=(MappedTable&& other) noexcept
+    {
+        if (this != &other) {
+            if (this->mapping) {
+                munmap(this->mapping, this->mapping_size);
+            }
+            static_cast<TableView&>(*this) = other;
+            this->mapping = exchange(other.mapping, nullptr);
+            this->mapping_size = exchange(other.mapping_size, 0);
+        }
+        return *this;
+    }
+
+    MappedTable::~MappedTable()
+    {
+        if (this->mapping) {
+            munmap(this->mapping, this->mapping_size);
+        }
+    }
+}
@@ -0,0 +1,180 @@
+#ifndef FA_DFA_MAPPED_H
+#define FA_DFA_MAPPED_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace fa::dfa
+{
+    /**
+     * Invalid (corrupt, truncated, or from another version or machine) serialized table.
+     */
+    class FormatError: public std::runtime_error
+    {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    /**
+     * Header of a serialized Table (see Table::save).
+     *
+     * The header is followed by the sections it points to, at 8 bytes aligned offsets from the
+     * start of the data, so the layout is position independent and can be used in place:
+     *
+     * - byte classes: 256 bytes, the class of every byte
+     * - transitions: state_count * class_count uint32_t, the table rows
+     * - accepting: (state_count + 63) / 64 uint64_t, the accepting states bitmap
+     * - accepted patterns: state_count * pattern_words uint64_t, the patterns bitset of every state
+     *
+     * Integers use the byte order of the machine that saved them (checked on load).
+     */
+    struct TableHeader {
+        static constexpr char MAGIC[8] = { 'F', 'A', 'D', 'F', 'A', 'T', 'B', 'L' };
+        static constexpr uint32_t VERSION = 1;
+        static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+        char magic[8];
+        uint32_t version;
+        uint32_t byte_order;
+        uint32_t class_count;
+        uint32_t state_count;
+        uint32_t starting_state;
+        uint32_t pattern_count;
+        uint32_t pattern_words;
+        uint32_t reserved;
+        uint64_t classes_offset;
+        uint64_t transitions_offset;
+        uint64_t accepting_offset;
+        uint64_t accepted_patterns_offset;
+        // of the whole serialized table, header included
+        uint64_t size;
+        // FNV-1a hash of everything after the header
+        uint64_t checksum;
+    };
+
+    /**
+     * 64 bits FNV-1a hash.
+     */
+    [[nodiscard]]
+    uint64_t fnv1a(const void* data, size_t size);
+
+    /**
+     * Read-only view of a serialized Table.
+     *
+     * Matches straight over the serialized data (like a memory mapped file) without copying it.
+     * The data must outlive the view and be 8 bytes aligned.
+     */
+    class TableView
+    {
+    protected:
+        const uint8_t* classes = nullptr;
+        const uint32_t* transitions = nullptr;
+        const uint64_t* accepting = nullptr;
+        const uint64_t* accepted_patterns = nullptr;
+        size_t class_count = 0;
+        size_t state_count = 0;
+        size_t pattern_count = 0;
+        size_t pattern_words = 0;
+        uint32_t starting_state = 0;
+
+        TableView() = default;
+
+    public:
+        /**
+         * Checks the header and points to the sections of the given serialized table. When verifying,
+         * it also checks the checksum and that every transition targets a valid state, which reads
+         * the whole data.
+         *
+         * Throws FormatError for invalid data.
+         */
+        TableView(const void* data, size_t size, bool verify = true);
+
+        /**
+         * Verifies if the whole given input matches the table.
+         */
+        [[nodiscard]]
+        bool matches(std::string_view input) const;
+
+        /**
+         * Length of the longest prefix of the input matching the table, if any.
+         */
+        [[nodiscard]]
+        std::optional<size_t> longest_match(std::string_view input) const;
+
+        [[nodiscard]]
+        uint32_t next(uint32_t state, unsigned char c) const
+        {
+            return this->transitions[state * this->class_count + this->classes[c]];
+        }
+
+        [[nodiscard]]
+        bool is_accepting(uint32_t state) const
+        {
+            return (this->accepting[state / 64] >> (state % 64)) & 1;
+        }
+
+        /**
+         * Bitset (pattern_words long) of the patterns accepted at the given state.
+         */
+        [[nodiscard]]
+        const uint64_t* get_accepted_patterns(uint32_t state) const
+        {
+            return this->accepted_patterns + state * this->pattern_words;
+        }
+
+        [[nodiscard]]
+        bool accepts_pattern(uint32_t state, size_t pattern) const
+        {
+            return (this->get_accepted_patterns(state)[pattern / 64] >> (pattern % 64)) & 1;
+        }
+
+        // GETTERS
+
+        [[nodiscard]]
+        uint32_t get_starting_state() const;
+
+        [[nodiscard]]
+        size_t get_state_count() const;
+
+        [[nodiscard]]
+        size_t get_class_count() const;
+
+        [[nodiscard]]
+        size_t get_pattern_count() const;
+
+        [[nodiscard]]
+        size_t get_pattern_words() const;
+    };
+
+    /**
+     * Serialized Table, memory mapped (read only) from a file.
+     *
+     * Loading doesn't copy the table, and every process mapping the same file shares a single copy
+     * of it in the page cache.
+     */
+    class MappedTable: public TableView
+    {
+    protected:
+        void* mapping = nullptr;
+        size_t mapping_size = 0;
+
+    public:
+        /**
+         * Maps the given file. Throws std::system_error if it can't be mapped, and FormatError if
+         * it isn't a valid serialized table (see TableView).
+         */
+        explicit MappedTable(const std::string& path, bool verify = true);
+
+        MappedTable(const MappedTable&) = delete;
+        MappedTable& operator=(const MappedTable&) = delete;
+        MappedTable(MappedTable&& other) noexcept;
+        MappedTable& operator=(MappedTable&& other) noexcept;
+        ~MappedTable();
+    };
+}
+
+#endif
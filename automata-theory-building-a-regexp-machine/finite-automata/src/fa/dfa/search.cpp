@@ -0,0 +1,138 @@
+#include "search.h"
+
+#include <cassert>
+#include <utility>
+
+using namespace std;
+using namespace fa;
+
+namespace fa::dfa
+{
+    Searcher::Searcher(nfa::NFA nfa)
+        : forward(nfa)
+        , reverse(nfa::reverse(nfa), false)
+        , literals(nfa::required_literals(nfa::Automaton{ nfa }))
+    {
+    }
+
+    bool Searcher::matches(string_view input) const
+    {
+        return this->forward.matches(input);
+    }
+
+    void Searcher::scan_backwards(string_view input, size_t from)
+    {
+        this->scanned = true;
+        this->scanned_size = input.size();
+        this->scanned_from = from;
+        // only [from, input.size()] is written and read, so the buffer is never cleared
+        if (this->match_starts.size() < input.size() + 1) {
+            this->match_starts.resize(input.size() + 1);
+        }
+
+        // the reverse DFA is unanchored: reading input[i..] backwards, it accepts iff a match starts at i
+        uint32_t state = this->reverse.get_starting_state();
+        this->match_starts[input.size()] = this->reverse.is_accepting(state);
+        for (size_t i = input.size(); i > from; i--) {
+            state = this->reverse.next(state, static_cast<unsigned char>(input[i - 1]));
+            this->match_starts[i - 1] = this->reverse.is_accepting(state);
+        }
+    }
+
+    /**
+     * Length of the longest match of the table at the start of the input, if any, and how many bytes
+     * it read before its DFA died (or the input ended).
+     */
+    static pair<optional<size_t>, size_t> walk_forward(const Table& table, string_view input)
+    {
+        uint32_t state = table.get_starting_state();
+        optional<size_t> longest;
+        if (table.is_accepting(state)) {
+            longest = 0;
+        }
+
+        for (size_t i = 0; i < input.size(); i++) {
+            state = table.next(state, static_cast<unsigned char>(input[i]));
+            if (state == Table::DEAD_STATE) {
+                return { longest, i + 1 };
+            }
+            if (table.is_accepting(state)) {
+                longest = i + 1;
+            }
+        }
+        return { longest, input.size() };
+    }
+
+    optional<Match> Searcher::find_from_scan(string_view input, size_t from)
+    {
+        if (!this->scanned || this->scanned_from > from) {
+            this->scan_backwards(input, from);
+        }
+        // find_next only continues over the same input
+        assert(this->scanned_size == input.size());
+
+        for (size_t start = from; start <= input.size(); start++) {
+            if (!this->match_starts[start]) {
+                continue;
+            }
+            optional<size_t> length = this->forward.longest_match(input.substr(start));
+            // the reverse DFA said so
+            assert(length);
+            return Match{ start, start + *length };
+        }
+
+        return nullopt;
+    }
+
+    optional<Match> Searcher::find_from_prefix(string_view input, size_t from)
+    {
+        // string_view::find looks for the first byte with memchr, which libc vectorizes
+        const string& prefix = this->literals.prefix;
+        for (size_t start = input.find(prefix, from); start != string_view::npos; start = input.find(prefix, start + 1)) {
+            // running the forward DFA again over bytes it already read would be quadratic (like
+            // ab[^c]*c over abab...), so the backward scan finds the matches from there on
+            if (start < this->walked_until || (this->scanned && this->scanned_from <= start)) {
+                return this->find_from_scan(input, start);
+            }
+            auto [length, walked] = walk_forward(this->forward, input.substr(start));
+            this->walked_until = start + walked;
+            if (length) {
+                return Match{ start, start + *length };
+            }
+        }
+        return nullopt;
+    }
+
+    optional<Match> Searcher::find(string_view input, size_t from)
+    {
+        return this->search(input, from, true);
+    }
+
+    optional<Match> Searcher::find_next(string_view input, size_t from)
+    {
+        return this->search(input, from, false);
+    }
+
+    optional<Match> Searcher::search(string_view input, size_t from, bool rescan)
+    {
+        assert(from <= input.size());
+
+        if (rescan) {
+            this->scanned = false;
+            this->walked_until = 0;
+        }
+        if (!this->literals.prefix.empty()) {
+            return this->find_from_prefix(input, from);
+        }
+        if (!this->literals.inner.empty() && input.find(this->literals.inner, from) == string_view::npos) {
+            return nullopt;
+        }
+
+        return this->find_from_scan(input, from);
+    }
+
+    const nfa::RequiredLiterals& Searcher::get_literals() const
+    {
+        return this->literals;
+    }
+}
@@ -0,0 +1,99 @@
+#ifndef FA_DFA_SEARCH_H
+#define FA_DFA_SEARCH_H
+
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include <fa/match.h>
+#include <fa/nfa/literals.h>
+#include <fa/nfa/nfa.h>
+
+#include "dfa.h"
+
+namespace fa::dfa
+{
+    /**
+     * DFA Searcher.
+     *
+     * Finds the leftmost-longest match positions inside an input at DFA speed, without the NFA
+     * Simulator. A forward DFA only tells where a match ends, so the searcher also builds the DFA
+     * of the reversed NFA:
+     *
+     * 1. The reverse (unanchored) DFA scans the input backwards, from its end. Its state is accepting
+     *    at every position where some match starts, and the leftmost of them is the match start.
+     * 2. The forward (anchored) DFA scans from that start, and its last accepting position is the
+     *    match end.
+     *
+     * Every find scans the input backwards again. find_next continues the previous search over the
+     * same input instead (like fa::Matches does), reusing the positions of its backward scan, so
+     * iterating over all matches only scans the input backwards once.
+     *
+     * When every match contains some literal (see nfa::RequiredLiterals), a fast substring search
+     * runs first: if every match starts with the literal, the search skips to its occurrences and
+     * tries them with the forward DFA. An occurrence inside the part of the input already read by
+     * such a forward run is left to the backward scan (from that occurrence) instead, so the input
+     * is read a bounded number of times. Otherwise, inputs not containing the literal are rejected
+     * without running any automaton (its occurrences don't limit the scanned part of the others).
+     */
+    class Searcher
+    {
+    protected:
+        Table forward;
+        Table reverse;
+        fa::nfa::RequiredLiterals literals;
+
+        // positions where some match starts, from the last backward scan (only valid from scanned_from)
+        bool scanned = false;
+        size_t scanned_size = 0;
+        size_t scanned_from = 0;
+        std::vector<bool> match_starts;
+        // end of the input read by the forward runs from the required prefix, since the last find
+        size_t walked_until = 0;
+
+        void scan_backwards(std::string_view input, size_t from);
+
+        std::optional<fa::Match> search(std::string_view input, size_t from, bool rescan);
+
+        /**
+         * The leftmost match starting at one of the positions found by the backward scan (scanning
+         * from the given position first, when the last scan doesn't cover it).
+         */
+        std::optional<fa::Match> find_from_scan(std::string_view input, size_t from);
+
+        /**
+         * Tries the forward DFA only at the occurrences of the required prefix.
+         */
+        std::optional<fa::Match> find_from_prefix(std::string_view input, size_t from);
+
+    public:
+        Searcher(fa::nfa::NFA nfa);
+
+        /**
+         * Verifies if the whole given input matches the NFA.
+         */
+        [[nodiscard]]
+        bool matches(std::string_view input) const;
+
+        /**
+         * Searches the leftmost-longest match inside the input, starting at or after the given position.
+         */
+        [[nodiscard]]
+        std::optional<fa::Match> find(std::string_view input, size_t from = 0);
+
+        /**
+         * Continues the previous search (made by find or find_next) over the same input, from a later position.
+         *
+         * The input must not have changed since: the positions of the previous backward scan are reused.
+         */
+        [[nodiscard]]
+        std::optional<fa::Match> find_next(std::string_view input, size_t from);
+
+        // GETTERS
+
+        [[nodiscard]]
+        const fa::nfa::RequiredLiterals& get_literals() const;
+    };
+}
+
+#endif
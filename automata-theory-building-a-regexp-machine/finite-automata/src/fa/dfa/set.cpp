@@ -0,0 +1,98 @@
+#include "set.h"
+
+#include <fa/nfa/automaton.h>
+#include <fa/nfa/literals.h>
+
+using namespace std;
+using namespace fa;
+
+namespace fa::dfa
+{
+    RegexSet::RegexSet(const vector<nfa::NFA>& nfas)
+        : anchored(nfa::Automaton{ nfas }, true)
+        , unanchored(nfa::Automaton{ nfas }, false)
+    {
+        if (nfas.size() > Teddy::MAX_LITERALS) {
+            return;
+        }
+
+        vector<string> prefixes;
+        for (const nfa::NFA& nfa: nfas) {
+            string prefix = nfa::required_literals(nfa::Automaton{ nfa }).prefix;
+            // a pattern that may start anywhere leaves nothing to skip
+            if (prefix.empty()) {
+                return;
+            }
+            prefixes.push_back(move(prefix));
+        }
+        this->prefilter.emplace(move(prefixes));
+    }
+
+    vector<size_t> RegexSet::patterns_from(const vector<uint64_t>& matched) const
+    {
+        vector<size_t> patterns;
+        for (size_t pattern = 0; pattern < this->get_pattern_count(); pattern++) {
+            if ((matched[pattern / 64] >> (pattern % 64)) & 1) {
+                patterns.push_back(pattern);
+            }
+        }
+        return patterns;
+    }
+
+    vector<size_t> RegexSet::matches(string_view input) const
+    {
+        uint32_t state = this->anchored.get_starting_state();
+        for (unsigned char c: input) {
+            state = this->anchored.next(state, c);
+            if (state == Table::DEAD_STATE) {
+                return {};
+            }
+        }
+
+        const uint64_t* accepted = this->anchored.get_accepted_patterns(state);
+        return this->patterns_from(vector<uint64_t>(accepted, accepted + this->anchored.get_pattern_words()));
+    }
+
+    vector<size_t> RegexSet::search(string_view input) const
+    {
+        const size_t words = this->unanchored.get_pattern_words();
+        vector<uint64_t> matched(words, 0);
+
+        // the unanchored DFA accepts at every position where some match ends
+        auto collect = [&](uint32_t state) {
+            if (this->unanchored.is_accepting(state)) {
+                const uint64_t* accepted = this->unanchored.get_accepted_patterns(state);
+                for (size_t i = 0; i < words; i++) {
+                    matched[i] |= accepted[i];
+                }
+            }
+        };
+
+        const uint32_t starting_state = this->unanchored.get_starting_state();
+        uint32_t state = starting_state;
+        collect(state);
+        for (size_t i = 0; i < input.size(); i++) {
+            // every match starts with a literal, so the bytes before the next one can't start any
+            if (state == starting_state && this->prefilter) {
+                i = this->prefilter->find(input, i);
+                if (i == string_view::npos) {
+                    break;
+                }
+            }
+            state = this->unanchored.next(state, static_cast<unsigned char>(input[i]));
+            collect(state);
+        }
+
+        return this->patterns_from(matched);
+    }
+
+    size_t RegexSet::get_pattern_count() const
+    {
+        return this->anchored.get_pattern_count();
+    }
+
+    const optional<Teddy>& RegexSet::get_prefilter() const
+    {
+        return this->prefilter;
+    }
+}
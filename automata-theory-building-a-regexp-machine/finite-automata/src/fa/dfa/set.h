@@ -0,0 +1,62 @@
+#ifndef FA_DFA_SET_H
+#define FA_DFA_SET_H
+
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include <fa/nfa/nfa.h>
+
+#include "dfa.h"
+#include "teddy.h"
+
+namespace fa::dfa
+{
+    /**
+     * Regex Set.
+     *
+     * Compiles many patterns into a single DFA (the `disjoint` of all of them, but keeping track of
+     * which pattern each accepting state comes from), so a single pass over the input tells every
+     * pattern that matched, instead of running each pattern on its own.
+     *
+     * Patterns are identified by their index in the constructor's vector.
+     *
+     * When every pattern starts with a literal (see nfa::RequiredLiterals), searches use a Teddy
+     * prefilter: while the unanchored DFA sits in its starting state (no match in progress), it
+     * jumps straight to the next position where some of those literals occurs.
+     */
+    class RegexSet
+    {
+    protected:
+        Table anchored;
+        Table unanchored;
+        std::optional<Teddy> prefilter;
+
+        std::vector<size_t> patterns_from(const std::vector<uint64_t>& matched) const;
+
+    public:
+        RegexSet(const std::vector<fa::nfa::NFA>& nfas);
+
+        /**
+         * Patterns matching the whole given input, in increasing index order.
+         */
+        [[nodiscard]]
+        std::vector<size_t> matches(std::string_view input) const;
+
+        /**
+         * Patterns matching anywhere inside the given input, in increasing index order.
+         */
+        [[nodiscard]]
+        std::vector<size_t> search(std::string_view input) const;
+
+        // GETTERS
+
+        [[nodiscard]]
+        size_t get_pattern_count() const;
+
+        [[nodiscard]]
+        const std::optional<Teddy>& get_prefilter() const;
+    };
+}
+
+#endif
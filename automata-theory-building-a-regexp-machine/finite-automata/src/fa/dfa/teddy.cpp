@@ -0,0 +1,200 @@
+#include "teddy.h"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define FA_TEDDY_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace fa::dfa
+{
+    Teddy::Isa Teddy::detect_isa()
+    {
+#ifdef FA_TEDDY_X86
+        if (__builtin_cpu_supports("avx2")) {
+            return Isa::AVX2;
+        }
+        if (__builtin_cpu_supports("ssse3")) {
+            return Isa::SSSE3;
+        }
+#endif
+        return Isa::SCALAR;
+    }
+
+    Teddy::Teddy(vector<string> literals, Isa isa)
+        : literals(move(literals))
+        , isa(min(isa, detect_isa()))
+    {
+        assert(!this->literals.empty() && this->literals.size() <= MAX_LITERALS);
+
+        this->mask_length = MAX_MASK_LENGTH;
+        for (const string& literal: this->literals) {
+            assert(!literal.empty());
+            this->mask_length = min(this->mask_length, literal.size());
+        }
+
+        // literals sharing their first bytes go to the same bucket, so they don't make other buckets match
+        vector<uint32_t> order(this->literals.size());
+        iota(order.begin(), order.end(), 0);
+        sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return this->literals[a] < this->literals[b];
+        });
+        for (size_t rank = 0; rank < order.size(); rank++) {
+            size_t bucket = rank * BUCKET_COUNT / order.size();
+            const string& literal = this->literals[order[rank]];
+            this->buckets[bucket].push_back(order[rank]);
+            for (size_t i = 0; i < this->mask_length; i++) {
+                auto c = static_cast<unsigned char>(literal[i]);
+                this->low_masks[i][c & 0xf] |= 1 << bucket;
+                this->high_masks[i][c >> 4] |= 1 << bucket;
+            }
+        }
+    }
+
+    bool Teddy::verify(string_view input, size_t position, uint8_t candidate_buckets) const
+    {
+        for (size_t bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+            if (!((candidate_buckets >> bucket) & 1)) {
+                continue;
+            }
+            for (uint32_t literal: this->buckets[bucket]) {
+                if (input.compare(position, this->literals[literal].size(), this->literals[literal]) == 0) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    size_t Teddy::find_scalar(string_view input, size_t from) const
+    {
+        for (size_t position = from; position + this->mask_length <= input.size(); position++) {
+            uint8_t candidate_buckets = 0xff;
+            for (size_t i = 0; i < this->mask_length; i++) {
+                auto c = static_cast<unsigned char>(input[position + i]);
+                candidate_buckets &= this->low_masks[i][c & 0xf] & this->high_masks[i][c >> 4];
+            }
+            if (candidate_buckets && this->verify(input, position, candidate_buckets)) {
+                return position;
+            }
+        }
+        return string_view::npos;
+    }
+
+#ifdef FA_TEDDY_X86
+    __attribute__((target("ssse3")))
+    size_t Teddy::find_ssse3(string_view input, size_t from) const
+    {
+        const __m128i low_nibbles = _mm_set1_epi8(0xf);
+        size_t position = from;
+        // every load of the chunk (one per mask byte) must stay inside the input
+        for (; position + 16 + this->mask_length - 1 <= input.size(); position += 16) {
+            __m128i candidates = _mm_set1_epi8(-1);
+            for (size_t i = 0; i < this->mask_length; i++) {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input.data() + position + i));
+                __m128i low = _mm_shuffle_epi8(
+                    _mm_load_si128(reinterpret_cast<const __m128i*>(this->low_masks[i])),
+                    _mm_and_si128(chunk, low_nibbles)
+                );
+                __m128i high = _mm_shuffle_epi8(
+                    _mm_load_si128(reinterpret_cast<const __m128i*>(this->high_masks[i])),
+                    _mm_and_si128(_mm_srli_epi16(chunk, 4), low_nibbles)
+                );
+                candidates = _mm_and_si128(candidates, _mm_and_si128(low, high));
+            }
+
+            auto found = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(candidates, _mm_setzero_si128()))) ^ 0xffff;
+            if (found) {
+                alignas(16) uint8_t candidate_buckets[16];
+                _mm_store_si128(reinterpret_cast<__m128i*>(candidate_buckets), candidates);
+                for (; found; found &= found - 1) {
+                    size_t offset = __builtin_ctz(found);
+                    if (this->verify(input, position + offset, candidate_buckets[offset])) {
+                        return position + offset;
+                    }
+                }
+            }
+        }
+        return this->find_scalar(input, position);
+    }
+
+    __attribute__((target("avx2")))
+    size_t Teddy::find_avx2(string_view input, size_t from) const
+    {
+        const __m256i low_nibbles = _mm256_set1_epi8(0xf);
+        // byte shuffles work on each 128 bits lane on its own, so both lanes get the same tables
+        __m256i low_masks[MAX_MASK_LENGTH];
+        __m256i high_masks[MAX_MASK_LENGTH];
+        for (size_t i = 0; i < this->mask_length; i++) {
+            low_masks[i] = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(this->low_masks[i])));
+            high_masks[i] = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(this->high_masks[i])));
+        }
+
+        size_t position = from;
+        for (; position + 32 + this->mask_length - 1 <= input.size(); position += 32) {
+            __m256i candidates = _mm256_set1_epi8(-1);
+            for (size_t i = 0; i < this->mask_length; i++) {
+                __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input.data() + position + i));
+                __m256i low = _mm256_shuffle_epi8(low_masks[i], _mm256_and_si256(chunk, low_nibbles));
+                __m256i high = _mm256_shuffle_epi8(high_masks[i], _mm256_and_si256(_mm256_srli_epi16(chunk, 4), low_nibbles));
+                candidates = _mm256_and_si256(candidates, _mm256_and_si256(low, high));
+            }
+
+            auto found = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(candidates, _mm256_setzero_si256())));
+            if (found) {
+                alignas(32) uint8_t candidate_buckets[32];
+                _mm256_store_si256(reinterpret_cast<__m256i*>(candidate_buckets), candidates);
+                for (; found; found &= found - 1) {
+                    size_t offset = __builtin_ctz(found);
+                    if (this->verify(input, position + offset, candidate_buckets[offset])) {
+                        return position + offset;
+                    }
+                }
+            }
+        }
+        return this->find_ssse3(input, position);
+    }
+#else
+    size_t Teddy::find_ssse3(string_view input, size_t from) const
+    {
+        return this->find_scalar(input, from);
+    }
+
+    size_t Teddy::find_avx2(string_view input, size_t from) const
+    {
+        return this->find_scalar(input, from);
+    }
+#endif
+
+    size_t Teddy::find(string_view input, size_t from) const
+    {
+        switch (this->isa) {
+        case Isa::AVX2:
+            return this->find_avx2(input, from);
+        case Isa::SSSE3:
+            return this->find_ssse3(input, from);
+        default:
+            return this->find_scalar(input, from);
+        }
+    }
+
+    const vector<string>& Teddy::get_literals() const
+    {
+        return this->literals;
+    }
+
+    size_t Teddy::get_mask_length() const
+    {
+        return this->mask_length;
+    }
+
+    Teddy::Isa Teddy::get_isa() const
+    {
+        return this->isa;
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef FA_DFA_TEDDY_H
+#define FA_DFA_TEDDY_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fa::dfa
+{
+    /**
+     * Teddy Multi-Literal Prefilter.
+     *
+     * Finds the positions where any of a set of literals occurs, testing 16 (SSSE3) or 32 (AVX2)
+     * positions at once. Literals are spread in 8 buckets, and for each of their first (up to 3)
+     * bytes two 16 entries tables give, by the low and the high nibble of an input byte, the bitset
+     * of buckets having a literal with that byte there. A single byte shuffle looks up the nibbles
+     * of a whole vector of input bytes, and ANDing all lookups leaves, at each position, the
+     * buckets that may have a literal starting there. Those candidates are then verified.
+     *
+     * Machines without SSSE3 (or other architectures) use the same tables one byte at a time.
+     */
+    class Teddy
+    {
+    public:
+        static constexpr size_t BUCKET_COUNT = 8;
+        static constexpr size_t MAX_MASK_LENGTH = 3;
+        /**
+         * Beyond this many literals, the buckets get so crowded that most positions are candidates.
+         */
+        static constexpr size_t MAX_LITERALS = 64;
+
+        enum class Isa { SCALAR, SSSE3, AVX2 };
+
+    protected:
+        std::vector<std::string> literals;
+        std::array<std::vector<uint32_t>, BUCKET_COUNT> buckets;
+        // number of leading bytes of the literals looked up by the masks
+        size_t mask_length;
+        alignas(16) uint8_t low_masks[MAX_MASK_LENGTH][16] = {};
+        alignas(16) uint8_t high_masks[MAX_MASK_LENGTH][16] = {};
+        Isa isa;
+
+        [[nodiscard]]
+        bool verify(std::string_view input, size_t position, uint8_t candidate_buckets) const;
+
+        [[nodiscard]]
+        size_t find_scalar(std::string_view input, size_t from) const;
+
+        [[nodiscard]]
+        size_t find_ssse3(std::string_view input, size_t from) const;
+
+        [[nodiscard]]
+        size_t find_avx2(std::string_view input, size_t from) const;
+
+    public:
+        /**
+         * The best instruction set supported by the running machine.
+         */
+        [[nodiscard]]
+        static Isa detect_isa();
+
+        /**
+         * Builds the prefilter for the given (non empty, at most MAX_LITERALS) literals.
+         * Instruction sets not supported by the running machine fall back to the best supported one.
+         */
+        explicit Teddy(std::vector<std::string> literals, Isa isa = detect_isa());
+
+        /**
+         * Position of the first occurrence of any literal, at or after the given position,
+         * or std::string_view::npos.
+         */
+        [[nodiscard]]
+        size_t find(std::string_view input, size_t from = 0) const;
+
+        // GETTERS
+
+        [[nodiscard]]
+        const std::vector<std::string>& get_literals() const;
+
+        [[nodiscard]]
+        size_t get_mask_length() const;
+
+        [[nodiscard]]
+        Isa get_isa() const;
+    };
+}
+
+#endif
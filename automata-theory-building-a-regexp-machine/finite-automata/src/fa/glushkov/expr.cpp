@@ -0,0 +1,207 @@
+#include "expr.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+using namespace std;
+using namespace fa;
+
+namespace fa::glushkov
+{
+    Expr::Expr(shared_ptr<const Node> root)
+        : root(move(root))
+    {
+    }
+
+    Expr::Expr(char c)
+        : Expr(range(c, c))
+    {
+    }
+
+    Expr::Expr()
+        : root(make_shared<const Node>(Node{ Kind::EMPTY, 0, 0, nullptr, nullptr }))
+    {
+    }
+
+    Expr Expr::make(Kind kind, const Expr& left, const Expr* right)
+    {
+        return Expr{ make_shared<const Node>(Node{ kind, 0, 0, left.root, right ? right->root : nullptr }) };
+    }
+
+    Expr Expr::operator+(const Expr& other) const
+    {
+        return make(Kind::CONCAT, *this, &other);
+    }
+
+    Expr Expr::operator|(const Expr& other) const
+    {
+        return make(Kind::UNION, *this, &other);
+    }
+
+    Expr zeroOrMore(const Expr& a)
+    {
+        return Expr::make(Expr::Kind::STAR, a);
+    }
+
+    Expr oneOrMore(const Expr& a)
+    {
+        return Expr::make(Expr::Kind::PLUS, a);
+    }
+
+    Expr opt(const Expr& a)
+    {
+        return Expr::make(Expr::Kind::OPTIONAL, a);
+    }
+
+    Expr range(char from, char to)
+    {
+        Expr::Node node{ Expr::Kind::SYMBOL, static_cast<unsigned char>(from), static_cast<unsigned char>(to), nullptr, nullptr };
+        assert(node.from <= node.to);
+
+        return Expr{ make_shared<const Expr::Node>(move(node)) };
+    }
+
+    Expr::Kind Expr::get_kind() const
+    {
+        return this->root->kind;
+    }
+
+    /**
+     * Numbers the positions of an expression and computes their first, last and follow sets.
+     */
+    class Compiler
+    {
+    protected:
+        struct Sets {
+            bool nullable;
+            // positions that may read the first (last) byte of a match
+            vector<uint32_t> first;
+            vector<uint32_t> last;
+        };
+
+        // the symbol interval of every position
+        vector<pair<unsigned char, unsigned char>> symbols;
+        // positions that may come right after every position
+        vector<vector<uint32_t>> follow;
+
+        void add_follow(const vector<uint32_t>& positions, const vector<uint32_t>& next_positions)
+        {
+            for (uint32_t position: positions) {
+                auto& follow = this->follow[position];
+                follow.insert(follow.end(), next_positions.begin(), next_positions.end());
+            }
+        }
+
+        Sets visit(const Expr::Node& node)
+        {
+            switch (node.kind) {
+            case Expr::Kind::EMPTY:
+                return Sets{ true, {}, {} };
+
+            case Expr::Kind::SYMBOL: {
+                auto position = static_cast<uint32_t>(this->symbols.size());
+                this->symbols.emplace_back(node.from, node.to);
+                this->follow.emplace_back();
+                return Sets{ false, { position }, { position } };
+            }
+
+            case Expr::Kind::CONCAT: {
+                Sets a = this->visit(*node.left);
+                Sets b = this->visit(*node.right);
+                this->add_follow(a.last, b.first);
+
+                Sets sets{ a.nullable && b.nullable, move(a.first), move(b.last) };
+                if (a.nullable) {
+                    sets.first.insert(sets.first.end(), b.first.begin(), b.first.end());
+                }
+                if (b.nullable) {
+                    sets.last.insert(sets.last.end(), a.last.begin(), a.last.end());
+                }
+                return sets;
+            }
+
+            case Expr::Kind::UNION: {
+                Sets a = this->visit(*node.left);
+                Sets b = this->visit(*node.right);
+                // both operands have their own positions, so there are no duplicates
+                a.nullable = a.nullable || b.nullable;
+                a.first.insert(a.first.end(), b.first.begin(), b.first.end());
+                a.last.insert(a.last.end(), b.last.begin(), b.last.end());
+                return a;
+            }
+
+            case Expr::Kind::STAR:
+            case Expr::Kind::PLUS: {
+                Sets a = this->visit(*node.left);
+                this->add_follow(a.last, a.first);
+                a.nullable = a.nullable || node.kind == Expr::Kind::STAR;
+                return a;
+            }
+
+            case Expr::Kind::OPTIONAL: {
+                Sets a = this->visit(*node.left);
+                a.nullable = true;
+                return a;
+            }
+            }
+
+            assert(false);
+            return Sets{ true, {}, {} };
+        }
+
+    public:
+        nfa::Automaton compile(const Expr& expr)
+        {
+            Sets sets = this->visit(*expr.root);
+
+            auto graph = make_shared<nfa::Graph>();
+            nfa::State* starting_state = graph->create_state(sets.nullable);
+            vector<nfa::State*> states;
+            for (size_t position = 0; position < this->symbols.size(); position++) {
+                states.push_back(graph->create_state(false));
+            }
+            for (uint32_t position: sets.last) {
+                states[position]->set_accepting(true);
+            }
+
+            // every transition into a position reads its symbol
+            auto add_transitions = [&](nfa::State* state, vector<uint32_t>& positions) {
+                sort(positions.begin(), positions.end());
+                positions.erase(unique(positions.begin(), positions.end()), positions.end());
+                for (uint32_t position: positions) {
+                    const auto& [from, to] = this->symbols[position];
+                    state->add_range_transition(static_cast<char>(from), static_cast<char>(to), states[position]);
+                }
+            };
+            add_transitions(starting_state, sets.first);
+            for (size_t position = 0; position < this->symbols.size(); position++) {
+                add_transitions(states[position], this->follow[position]);
+            }
+
+            return nfa::Automaton{ graph, starting_state };
+        }
+    };
+
+    size_t Expr::get_position_count() const
+    {
+        size_t count = 0;
+        vector<const Node*> stack{ this->root.get() };
+        while (!stack.empty()) {
+            const Node* node = stack.back();
+            stack.pop_back();
+            count += node->kind == Kind::SYMBOL;
+            for (const Node* child: { node->left.get(), node->right.get() }) {
+                if (child) {
+                    stack.push_back(child);
+                }
+            }
+        }
+        return count;
+    }
+
+    nfa::Automaton compile(const Expr& expr)
+    {
+        return Compiler{}.compile(expr);
+    }
+}
@@ -0,0 +1,130 @@
+#ifndef FA_GLUSHKOV_EXPR_H
+#define FA_GLUSHKOV_EXPR_H
+
+#include <memory>
+#include <vector>
+
+#include <fa/nfa/automaton.h>
+
+namespace fa::glushkov
+{
+    /**
+     * Regular Expression for the Glushkov (position automaton) construction.
+     *
+     * Built with the same combinators as the Thompson NFA fragments (concat, disjoint, zeroOrMore,
+     * oneOrMore, opt, range), but it just records the expression tree. Compiling it numbers every
+     * symbol occurrence (position) and computes which positions may come first, last, and after
+     * each other. The resulting automaton has a starting state plus one state per position, and
+     * no epsilon transitions at all: every transition into a position reads that position symbol.
+     *
+     * Expressions are immutable, so subexpressions can be freely shared.
+     */
+    class Expr
+    {
+    public:
+        enum class Kind { EMPTY, SYMBOL, CONCAT, UNION, STAR, PLUS, OPTIONAL };
+
+    protected:
+        struct Node {
+            Kind kind;
+            // the byte interval of a SYMBOL
+            unsigned char from = 0;
+            unsigned char to = 0;
+            std::shared_ptr<const Node> left;
+            std::shared_ptr<const Node> right;
+        };
+
+        std::shared_ptr<const Node> root;
+
+        explicit Expr(std::shared_ptr<const Node> root);
+
+        [[nodiscard]]
+        static Expr make(Kind kind, const Expr& left, const Expr* right = nullptr);
+
+        friend class Compiler;
+
+    public:
+        /**
+         * Single character (byte) expression.
+         */
+        Expr(char c);
+
+        /**
+         * Epsilon (empty string) expression.
+         */
+        Expr();
+
+        /**
+         * Concatenation.
+         */
+        [[nodiscard]]
+        Expr operator+(const Expr& other) const;
+
+        /**
+         * Union.
+         */
+        [[nodiscard]]
+        Expr operator|(const Expr& other) const;
+
+        friend Expr zeroOrMore(const Expr& a);
+
+        friend Expr oneOrMore(const Expr& a);
+
+        friend Expr opt(const Expr& a);
+
+        friend Expr range(char from, char to);
+
+        /**
+         * Number of symbol occurrences, which is the number of non starting states of the compiled automaton.
+         */
+        [[nodiscard]]
+        size_t get_position_count() const;
+
+        [[nodiscard]]
+        Kind get_kind() const;
+    };
+
+    /**
+     * Fold left all expressions using the concatenation '+' operator.
+     */
+    template <typename... ExprArgs>
+    Expr concat(ExprArgs... exprs) {
+        return (... + exprs);
+    }
+
+    /**
+     * Fold left all expressions using the union '|' operator.
+     */
+    template <typename... ExprArgs>
+    Expr disjoint(ExprArgs... exprs) {
+        return (... | exprs);
+    }
+
+    /**
+     * Kleene star: a*.
+     */
+    Expr zeroOrMore(const Expr& a);
+
+    /**
+     * a+.
+     */
+    Expr oneOrMore(const Expr& a);
+
+    /**
+     * a?.
+     */
+    Expr opt(const Expr& a);
+
+    /**
+     * Character class (range) [from-to], a single position.
+     */
+    Expr range(char from, char to);
+
+    /**
+     * Builds the (epsilon free) position automaton of the given expression.
+     */
+    [[nodiscard]]
+    fa::nfa::Automaton compile(const Expr& expr);
+}
+
+#endif
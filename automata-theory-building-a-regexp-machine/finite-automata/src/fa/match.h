@@ -0,0 +1,128 @@
+#ifndef FA_MATCH_H
+#define FA_MATCH_H
+
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace fa
+{
+    /**
+     * Position of a match in the searched input: the bytes in [start, end).
+     */
+    struct Match {
+        size_t start;
+        size_t end;
+
+        [[nodiscard]]
+        size_t size() const
+        {
+            return this->end - this->start;
+        }
+
+        [[nodiscard]]
+        bool operator==(const Match& other) const
+        {
+            return this->start == other.start && this->end == other.end;
+        }
+
+        [[nodiscard]]
+        bool operator!=(const Match& other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+    namespace detail
+    {
+        template <typename Engine, typename = void>
+        struct has_find_next : std::false_type {};
+
+        template <typename Engine>
+        struct has_find_next<Engine, std::void_t<decltype(
+            std::declval<Engine&>().find_next(std::declval<std::string_view>(), std::size_t{})
+        )>> : std::true_type {};
+    }
+
+    /**
+     * All successive non-overlapping matches of an engine over an input.
+     *
+     * The Engine just needs a `std::optional<Match> find(std::string_view input, size_t from)`
+     * method returning the leftmost match starting at or after `from`. Each search starts
+     * where the previous match ended (or one byte later, after an empty match). Engines that
+     * can continue their previous search over the same input (like fa::dfa::Searcher) also
+     * have a `find_next(std::string_view input, size_t from)` method, used for every search
+     * but the first one. The input must not change while iterating.
+     *
+     * The Engine can be a reference, to iterate with an engine owned by the caller.
+     *
+     * Usage:
+     *     for (fa::Match match: fa::Matches{ engine, input }) { ... }
+     */
+    template <typename Engine>
+    class Matches
+    {
+    protected:
+        Engine engine;
+        std::string_view input;
+
+    public:
+        class iterator
+        {
+        protected:
+            Matches* matches;
+            std::optional<Match> current;
+
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = Match;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Match*;
+            using reference = const Match&;
+
+            iterator(Matches* matches, std::optional<Match> current)
+                : matches(matches), current(current)
+            {
+            }
+
+            reference operator*() const { return *this->current; }
+            pointer operator->() const { return &*this->current; }
+
+            iterator& operator++()
+            {
+                size_t from = this->current->end + (this->current->start == this->current->end ? 1 : 0);
+                if (from > this->matches->input.size()) {
+                    this->current = std::nullopt;
+                } else if constexpr (detail::has_find_next<Engine>::value) {
+                    this->current = this->matches->engine.find_next(this->matches->input, from);
+                } else {
+                    this->current = this->matches->engine.find(this->matches->input, from);
+                }
+                return *this;
+            }
+
+            bool operator==(const iterator& other) const { return this->current == other.current; }
+            bool operator!=(const iterator& other) const { return !(*this == other); }
+        };
+
+        Matches(Engine engine, std::string_view input)
+            : engine(std::forward<Engine>(engine)), input(input)
+        {
+        }
+
+        iterator begin()
+        {
+            return iterator{ this, this->engine.find(this->input, 0) };
+        }
+
+        iterator end()
+        {
+            return iterator{ this, std::nullopt };
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,195 @@
+#include "automaton.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <tuple>
+
+#include <fa/sparse_set.h>
+
+using namespace std;
+
+namespace fa::nfa
+{
+    /**
+     * States reachable from the input state of a NFA, in their graph id order.
+     *
+     * Numbering states in this order keeps states built together (like a fragment input and
+     * output) close together.
+     */
+    static vector<const State*> reachable_states(const NFA& nfa)
+    {
+        vector<const State*> reachable;
+        SparseSet visited{ Graph::root(nfa.graph)->get_state_count() };
+        vector<const State*> stack{ nfa.in };
+        while (!stack.empty()) {
+            const State* state = stack.back();
+            stack.pop_back();
+
+            if (!visited.insert(state->get_id())) {
+                continue;
+            }
+            reachable.push_back(state);
+
+            for (const State* next_state: state->get_epsilon_transitions()) {
+                stack.push_back(next_state);
+            }
+            for (const Transition& transition: state->get_transitions()) {
+                stack.push_back(transition.target);
+            }
+        }
+        sort(reachable.begin(), reachable.end(), [](const State* a, const State* b) {
+            return a->get_id() < b->get_id();
+        });
+
+        return reachable;
+    }
+
+    Automaton::Automaton(const NFA& nfa)
+        : Automaton(vector<NFA>{ nfa })
+    {
+    }
+
+    Automaton::Automaton(shared_ptr<Graph> graph, State* starting_state)
+        // only transitions from the input state are followed, the output state is irrelevant
+        : Automaton(NFA{ move(graph), starting_state, starting_state })
+    {
+    }
+
+    Automaton::Automaton(const vector<NFA>& nfas)
+        : pattern_count(nfas.size())
+    {
+        assert(!nfas.empty());
+
+        // several patterns share a synthetic starting state, with epsilon transitions to each of them
+        const bool synthetic_start = nfas.size() > 1;
+
+        // Every pattern gets its own copy of its states, even if some are shared with another pattern, so
+        // each accepting state belongs to a single pattern.
+        vector<vector<const State*>> pattern_states;
+        // automaton state of each graph state id, for every pattern
+        vector<vector<uint32_t>> pattern_ids;
+        size_t state_count = synthetic_start ? 1 : 0;
+        for (const NFA& nfa: nfas) {
+            pattern_states.push_back(reachable_states(nfa));
+
+            auto& ids = pattern_ids.emplace_back(Graph::root(nfa.graph)->get_state_count());
+            for (const State* state: pattern_states.back()) {
+                ids[state->get_id()] = static_cast<uint32_t>(state_count++);
+            }
+        }
+        assert(state_count < numeric_limits<uint32_t>::max());
+
+        this->accepting.reserve(state_count);
+        this->patterns.reserve(state_count);
+        this->epsilon_offsets.reserve(state_count + 1);
+        this->edge_offsets.reserve(state_count + 1);
+
+        if (synthetic_start) {
+            this->starting_state = 0;
+            this->accepting.push_back(false);
+            this->patterns.push_back(0);
+            this->epsilon_offsets.push_back(0);
+            this->edge_offsets.push_back(0);
+            for (size_t pattern = 0; pattern < nfas.size(); pattern++) {
+                this->epsilon_targets.push_back(pattern_ids[pattern][nfas[pattern].in->get_id()]);
+            }
+        } else {
+            this->starting_state = pattern_ids[0][nfas[0].in->get_id()];
+        }
+
+        for (size_t pattern = 0; pattern < nfas.size(); pattern++) {
+            const auto& ids = pattern_ids[pattern];
+            for (const State* state: pattern_states[pattern]) {
+                this->accepting.push_back(state->is_accepting());
+                this->patterns.push_back(static_cast<uint32_t>(pattern));
+
+                this->epsilon_offsets.push_back(static_cast<uint32_t>(this->epsilon_targets.size()));
+                for (const State* next_state: state->get_epsilon_transitions()) {
+                    this->epsilon_targets.push_back(ids[next_state->get_id()]);
+                }
+
+                this->edge_offsets.push_back(static_cast<uint32_t>(this->edges.size()));
+                for (const Transition& transition: state->get_transitions()) {
+                    this->edges.push_back(Edge{ transition.from, transition.to, ids[transition.target->get_id()] });
+                }
+            }
+        }
+        this->epsilon_offsets.push_back(static_cast<uint32_t>(this->epsilon_targets.size()));
+        this->edge_offsets.push_back(static_cast<uint32_t>(this->edges.size()));
+    }
+
+    Automaton Automaton::without_epsilons() const
+    {
+        assert(this->pattern_count == 1);
+
+        const size_t state_count = this->get_state_count();
+        vector<bool> closure_accepting(state_count, false);
+        vector<vector<Edge>> closure_edges(state_count);
+
+        SparseSet reachable{ state_count };
+        SparseSet closure{ state_count };
+        vector<uint32_t> pending{ this->starting_state };
+        vector<uint32_t> stack;
+        while (!pending.empty()) {
+            uint32_t state = pending.back();
+            pending.pop_back();
+            if (!reachable.insert(state)) {
+                continue;
+            }
+
+            closure.clear();
+            stack.push_back(state);
+            while (!stack.empty()) {
+                uint32_t closed_state = stack.back();
+                stack.pop_back();
+                if (!closure.insert(closed_state)) {
+                    continue;
+                }
+                if (this->accepting[closed_state]) {
+                    closure_accepting[state] = true;
+                }
+                for (const Edge& edge: this->get_transitions(closed_state)) {
+                    closure_edges[state].push_back(edge);
+                    pending.push_back(edge.target);
+                }
+                for (uint32_t next_state: this->get_epsilon_transitions(closed_state)) {
+                    stack.push_back(next_state);
+                }
+            }
+
+            auto& edges = closure_edges[state];
+            sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) {
+                return tie(a.from, a.to, a.target) < tie(b.from, b.to, b.target);
+            });
+            edges.erase(unique(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) {
+                return a.from == b.from && a.to == b.to && a.target == b.target;
+            }), edges.end());
+        }
+
+        // surviving states keep their relative order
+        vector<uint32_t> states(reachable.begin(), reachable.end());
+        sort(states.begin(), states.end());
+        vector<uint32_t> ids(state_count, 0);
+        for (size_t i = 0; i < states.size(); i++) {
+            ids[states[i]] = static_cast<uint32_t>(i);
+        }
+
+        Automaton automaton;
+        automaton.starting_state = ids[this->starting_state];
+        automaton.accepting.reserve(states.size());
+        automaton.patterns.assign(states.size(), 0);
+        automaton.epsilon_offsets.assign(states.size() + 1, 0);
+        automaton.edge_offsets.reserve(states.size() + 1);
+        for (uint32_t state: states) {
+            automaton.accepting.push_back(closure_accepting[state]);
+            automaton.edge_offsets.push_back(static_cast<uint32_t>(automaton.edges.size()));
+            for (const Edge& edge: closure_edges[state]) {
+                automaton.edges.push_back(Edge{ edge.from, edge.to, ids[edge.target] });
+            }
+        }
+        automaton.edge_offsets.push_back(static_cast<uint32_t>(automaton.edges.size()));
+
+        return automaton;
+    }
+}
@@ -0,0 +1,153 @@
+#ifndef FA_NFA_AUTOMATON_H
+#define FA_NFA_AUTOMATON_H
+
+#include <cstdint>
+#include <vector>
+
+#include "nfa.h"
+
+namespace fa::nfa
+{
+    /**
+     * A read-only view over a contiguous range of items.
+     */
+    template <typename T>
+    class Range
+    {
+    protected:
+        const T* first;
+        const T* last;
+
+    public:
+        Range(const T* first, const T* last)
+            : first(first), last(last)
+        {
+        }
+
+        const T* begin() const { return this->first; }
+        const T* end() const { return this->last; }
+        size_t size() const { return static_cast<size_t>(this->last - this->first); }
+        bool empty() const { return this->first == this->last; }
+    };
+
+    /**
+     * Frozen NFA.
+     *
+     * A compact, read-only copy of a NFA built for matching engines. States reachable from
+     * the NFA input state are numbered densely (following their allocation order in the Graph)
+     * and their transitions are stored contiguously in CSR (compressed sparse row) style:
+     * the transitions of state s are the ones between offsets[s] and offsets[s + 1].
+     *
+     * Epsilon transitions and byte transitions are kept in separate arrays. Byte transitions
+     * are byte intervals and the ones of every state are sorted by interval start.
+     *
+     * Several NFAs (patterns) may be frozen together into a single automaton. Every state is
+     * then tagged with the index of the pattern it belongs to, so accepting states tell which
+     * pattern matched.
+     */
+    class Automaton
+    {
+    public:
+        struct Edge {
+            unsigned char from;
+            unsigned char to;
+            uint32_t target;
+
+            [[nodiscard]]
+            bool contains(unsigned char c) const
+            {
+                return this->from <= c && c <= this->to;
+            }
+        };
+
+    protected:
+        uint32_t starting_state = 0;
+        size_t pattern_count = 1;
+        std::vector<bool> accepting;
+        std::vector<uint32_t> patterns;
+        std::vector<uint32_t> epsilon_offsets;
+        std::vector<uint32_t> epsilon_targets;
+        std::vector<uint32_t> edge_offsets;
+        std::vector<Edge> edges;
+
+        Automaton() = default;
+
+    public:
+        explicit Automaton(const NFA& nfa);
+
+        /**
+         * Freezes all given patterns into a single automaton, matching any of them.
+         */
+        explicit Automaton(const std::vector<NFA>& nfas);
+
+        /**
+         * Freezes the states of the given graph reachable from the given starting state.
+         *
+         * Unlike NFA fragments, the graph may have any number of accepting states.
+         */
+        Automaton(std::shared_ptr<Graph> graph, State* starting_state);
+
+        /**
+         * Equivalent automaton without epsilon transitions.
+         *
+         * Every state gets the byte transitions of its whole epsilon closure, and is accepting if
+         * any state of its closure is. States then only reachable through epsilon transitions are
+         * dropped. Engines no longer chase epsilon transitions on every input byte, at the price of
+         * (possibly) more byte transitions per state.
+         *
+         * Only single pattern automata: the closure of the synthetic starting state of several
+         * patterns may accept more than one of them.
+         */
+        [[nodiscard]]
+        Automaton without_epsilons() const;
+
+        [[nodiscard]]
+        size_t get_state_count() const
+        {
+            return this->accepting.size();
+        }
+
+        [[nodiscard]]
+        uint32_t get_starting_state() const
+        {
+            return this->starting_state;
+        }
+
+        [[nodiscard]]
+        bool is_accepting(uint32_t state) const
+        {
+            return this->accepting[state];
+        }
+
+        /**
+         * Index of the pattern the given state belongs to.
+         */
+        [[nodiscard]]
+        uint32_t get_pattern(uint32_t state) const
+        {
+            return this->patterns[state];
+        }
+
+        [[nodiscard]]
+        size_t get_pattern_count() const
+        {
+            return this->pattern_count;
+        }
+
+        [[nodiscard]]
+        Range<uint32_t> get_epsilon_transitions(uint32_t state) const
+        {
+            const uint32_t* targets = this->epsilon_targets.data();
+            return { targets + this->epsilon_offsets[state], targets + this->epsilon_offsets[state + 1] };
+        }
+
+        [[nodiscard]]
+        Range<Edge> get_transitions(uint32_t state) const
+        {
+            const Edge* edges = this->edges.data();
+            return { edges + this->edge_offsets[state], edges + this->edge_offsets[state + 1] };
+        }
+    };
+}
+
+#endif
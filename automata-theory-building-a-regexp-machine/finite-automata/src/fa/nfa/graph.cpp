@@ -1,5 +1,6 @@
 #include "graph.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "state.h"
@@ -8,11 +9,66 @@ using namespace std;
 
 namespace fa::nfa
 {
+    Graph::~Graph() = default;
+
     State* Graph::create_state(bool accepting)
     {
-        // Trust me I'm an Engineer!
-        State* state = new State(accepting);
-        this->states.emplace_back(state);
+        if (this->blocks.empty() || this->blocks.back().size == this->blocks.back().capacity) {
+            // blocks grow along with the graph, so tiny fragments stay tiny
+            size_t capacity = clamp(this->state_count, MIN_BLOCK_SIZE, MAX_BLOCK_SIZE);
+            this->blocks.push_back(Block{ make_unique<State[]>(capacity), 0, capacity });
+        }
+
+        Block& block = this->blocks.back();
+        State* state = &block.states[block.size++];
+        state->set_accepting(accepting);
+        state->id = static_cast<uint32_t>(this->state_count++);
+
         return state;
     }
+
+    shared_ptr<Graph> Graph::root(shared_ptr<Graph> graph)
+    {
+        while (graph->merged_into) {
+            graph = graph->merged_into;
+        }
+        return graph;
+    }
+
+    shared_ptr<Graph> Graph::merge(shared_ptr<Graph> a, shared_ptr<Graph> b)
+    {
+        a = root(a);
+        b = root(b);
+        if (a == b) {
+            return a;
+        }
+        if (a->state_count < b->state_count) {
+            swap(a, b);
+        }
+
+        for (Block& block: b->blocks) {
+            for (size_t i = 0; i < block.size; i++) {
+                block.states[i].id += static_cast<uint32_t>(a->state_count);
+            }
+        }
+
+        // keep a's last (partially filled) block at the end so it keeps being filled
+        a->blocks.insert(
+            a->blocks.end() - (a->blocks.empty() ? 0 : 1),
+            make_move_iterator(b->blocks.begin()),
+            make_move_iterator(b->blocks.end())
+        );
+        a->state_count += b->state_count;
+
+        b->blocks.clear();
+        b->state_count = 0;
+        b->merged_into = a;
+
+        return a;
+    }
+
+    size_t Graph::get_state_count() const
+    {
+        return this->state_count;
+    }
 }
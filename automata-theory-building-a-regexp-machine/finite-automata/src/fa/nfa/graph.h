@@ -1,19 +1,82 @@
 #ifndef FA_NFA_GRAPH_H
 #define FA_NFA_GRAPH_H
 
-#include <list>
 #include <memory>
+#include <vector>
 
 namespace fa::nfa
 {
     class State;
 
+    /**
+     * NFA Graph.
+     *
+     * Arena that owns all states of an automaton. States are allocated in blocks and
+     * never move, so transitions and NFA fragments just hold plain State pointers to them.
+     * All states are released at once when the graph is destroyed, even if their
+     * transitions form loops.
+     *
+     * Composing fragments from different graphs merges them: the smaller graph hands its
+     * blocks over to the bigger one and then just forwards to it, keeping it alive for
+     * any fragment that still refers to the old graph.
+     *
+     * Every state gets a dense id in [0, state count), so per state data can live in plain
+     * arrays (or a SparseSet) instead of trees keyed by pointers. Merging renumbers the
+     * states of the smaller graph after the ones of the bigger graph.
+     */
     class Graph {
+    public:
+        static constexpr size_t MIN_BLOCK_SIZE = 4;
+        static constexpr size_t MAX_BLOCK_SIZE = 1024;
+
     protected:
-        std::list<std::unique_ptr<State>> states;
+        struct Block {
+            std::unique_ptr<State[]> states;
+            size_t size;
+            size_t capacity;
+        };
+
+        std::vector<Block> blocks;
+        size_t state_count = 0;
+        std::shared_ptr<Graph> merged_into;
 
     public:
+        Graph() = default;
+        Graph(const Graph&) = delete;
+        Graph& operator=(const Graph&) = delete;
+        ~Graph();
+
         State* create_state(bool accepting = false);
+
+        /**
+         * The graph that currently owns the states of the given graph.
+         */
+        [[nodiscard]]
+        static std::shared_ptr<Graph> root(std::shared_ptr<Graph> graph);
+
+        /**
+         * Merges both graphs, returning the one that ends up owning all states.
+         */
+        [[nodiscard]]
+        static std::shared_ptr<Graph> merge(std::shared_ptr<Graph> a, std::shared_ptr<Graph> b);
+
+        /**
+         * Calls f for every state owned by this graph, in allocation order.
+         */
+        template <typename F>
+        void for_each_state(F f) const
+        {
+            for (const Block& block: this->blocks) {
+                for (size_t i = 0; i < block.size; i++) {
+                    f(&block.states[i]);
+                }
+            }
+        }
+
+        // GETTERS
+
+        [[nodiscard]]
+        size_t get_state_count() const;
     };
 };
 
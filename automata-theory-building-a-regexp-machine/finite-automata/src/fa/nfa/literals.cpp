@@ -0,0 +1,135 @@
+#include "literals.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+using namespace std;
+
+namespace fa::nfa
+{
+    /**
+     * Replaces the given states by their epsilon closure.
+     */
+    static void close(const Automaton& automaton, vector<uint32_t>& states)
+    {
+        vector<bool> listed(automaton.get_state_count(), false);
+        vector<uint32_t> stack = move(states);
+        states.clear();
+        while (!stack.empty()) {
+            uint32_t state = stack.back();
+            stack.pop_back();
+            if (listed[state]) {
+                continue;
+            }
+            listed[state] = true;
+            states.push_back(state);
+            for (uint32_t next_state: automaton.get_epsilon_transitions(state)) {
+                stack.push_back(next_state);
+            }
+        }
+    }
+
+    /**
+     * The byte read by every transition leaving the given (closed) states, if they all read the
+     * very same single byte and none of the states is accepting. Moves the states forward reading it.
+     */
+    static optional<unsigned char> forced_byte(const Automaton& automaton, vector<uint32_t>& states)
+    {
+        optional<unsigned char> forced;
+        vector<uint32_t> next_states;
+        for (uint32_t state: states) {
+            if (automaton.is_accepting(state)) {
+                return nullopt;
+            }
+            for (const auto& edge: automaton.get_transitions(state)) {
+                if (edge.from != edge.to || (forced && *forced != edge.from)) {
+                    return nullopt;
+                }
+                forced = edge.from;
+                next_states.push_back(edge.target);
+            }
+        }
+        if (forced) {
+            states = move(next_states);
+            close(automaton, states);
+        }
+        return forced;
+    }
+
+    /**
+     * The literal read along the chain of forced bytes from the given (closed) states.
+     */
+    static string forced_literal(const Automaton& automaton, vector<uint32_t> states)
+    {
+        string literal;
+        while (literal.size() < MAX_LITERAL_LENGTH) {
+            optional<unsigned char> c = forced_byte(automaton, states);
+            if (!c) {
+                break;
+            }
+            literal.push_back(static_cast<char>(*c));
+        }
+        return literal;
+    }
+
+    /**
+     * Verifies if some accepting state is reachable without taking the given edge.
+     */
+    static bool accepts_without(const Automaton& automaton, const Automaton::Edge* skipped)
+    {
+        vector<bool> visited(automaton.get_state_count(), false);
+        vector<uint32_t> stack{ automaton.get_starting_state() };
+        while (!stack.empty()) {
+            uint32_t state = stack.back();
+            stack.pop_back();
+            if (visited[state]) {
+                continue;
+            }
+            visited[state] = true;
+            if (automaton.is_accepting(state)) {
+                return true;
+            }
+            for (uint32_t next_state: automaton.get_epsilon_transitions(state)) {
+                stack.push_back(next_state);
+            }
+            for (const auto& edge: automaton.get_transitions(state)) {
+                if (&edge != skipped) {
+                    stack.push_back(edge.target);
+                }
+            }
+        }
+        return false;
+    }
+
+    RequiredLiterals required_literals(const Automaton& automaton)
+    {
+        RequiredLiterals literals;
+
+        vector<uint32_t> starting_states{ automaton.get_starting_state() };
+        close(automaton, starting_states);
+        literals.prefix = forced_literal(automaton, starting_states);
+        literals.inner = literals.prefix;
+
+        // every single byte transition may start a required chain
+        for (uint32_t state = 0; state < automaton.get_state_count(); state++) {
+            for (const auto& edge: automaton.get_transitions(state)) {
+                if (edge.from != edge.to) {
+                    continue;
+                }
+
+                vector<uint32_t> states{ edge.target };
+                close(automaton, states);
+                string literal = string(1, static_cast<char>(edge.from)) + forced_literal(automaton, states);
+                literal.resize(min(literal.size(), MAX_LITERAL_LENGTH));
+
+                if (literal.size() > literals.inner.size() && !accepts_without(automaton, &edge)) {
+                    literals.inner = move(literal);
+                }
+            }
+        }
+
+        return literals;
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef FA_NFA_LITERALS_H
+#define FA_NFA_LITERALS_H
+
+#include <string>
+
+#include "automaton.h"
+
+namespace fa::nfa
+{
+    /**
+     * Literals that every match of an automaton must contain.
+     *
+     * They let searches skip ahead with a fast substring search (memchr based, which libc
+     * vectorizes) and only run the automaton around candidate positions, or not at all.
+     */
+    struct RequiredLiterals {
+        /**
+         * Every match starts with this literal (like "ERROR" in `ERROR[0-9]+`).
+         */
+        std::string prefix;
+
+        /**
+         * Every match contains this literal somewhere (like "ERROR" in `[0-9]+ERROR`). It's
+         * the longest one found, so it may be the prefix itself.
+         */
+        std::string inner;
+    };
+
+    /**
+     * Maximum length of the extracted literals.
+     */
+    constexpr size_t MAX_LITERAL_LENGTH = 64;
+
+    /**
+     * Extracts the required prefix and inner literals of the given (single pattern) automaton.
+     *
+     * A literal is a chain of single byte transitions where, between two of them, the only way
+     * forward is following epsilon transitions (without reaching an accepting state). A chain
+     * is required when the automaton can't accept without taking its first transition.
+     */
+    [[nodiscard]]
+    RequiredLiterals required_literals(const Automaton& automaton);
+}
+
+#endif
@@ -0,0 +1,33 @@
+#include "matcher.h"
+
+using namespace std;
+
+namespace fa::nfa
+{
+    Matcher::Matcher(const NFA& nfa)
+        : Matcher(Automaton{ nfa })
+    {
+    }
+
+    Matcher::Matcher(const Automaton& automaton)
+    {
+        if (ShiftAnd::fits(automaton)) {
+            this->shift_and.emplace(automaton);
+        } else {
+            this->simulator.emplace(automaton.without_epsilons());
+        }
+    }
+
+    bool Matcher::matches(string_view input)
+    {
+        if (this->shift_and) {
+            return this->shift_and->matches(input);
+        }
+        return this->simulator->matches(input);
+    }
+
+    bool Matcher::is_shift_and() const
+    {
+        return this->shift_and.has_value();
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef FA_NFA_MATCHER_H
+#define FA_NFA_MATCHER_H
+
+#include <optional>
+#include <string_view>
+
+#include "automaton.h"
+#include "nfa.h"
+#include "shift_and.h"
+#include "simulator.h"
+
+namespace fa::nfa
+{
+    /**
+     * NFA Matcher.
+     *
+     * Picks the fastest NFA engine for an automaton once, when built: the bit-parallel ShiftAnd
+     * when the automaton fits in it (see ShiftAnd::fits), or the NFA Simulator otherwise. Build it
+     * once and reuse it to match many inputs against the same NFA (NFA::matches builds one on every
+     * call).
+     */
+    class Matcher
+    {
+    protected:
+        std::optional<ShiftAnd> shift_and;
+        std::optional<Simulator> simulator;
+
+    public:
+        explicit Matcher(const NFA& nfa);
+
+        explicit Matcher(const Automaton& automaton);
+
+        /**
+         * Verifies if the whole given input matches the automaton.
+         */
+        [[nodiscard]]
+        bool matches(std::string_view input);
+
+        // GETTERS
+
+        /**
+         * Whether the matcher runs the bit-parallel ShiftAnd (or the NFA Simulator otherwise).
+         */
+        [[nodiscard]]
+        bool is_shift_and() const;
+    };
+}
+
+#endif
@@ -1,5 +1,8 @@
 #include "nfa.h"
+#include "matcher.h"
+#include "simulator.h"
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <unordered_map>
@@ -7,6 +10,7 @@
 #include <cstring>
 #include <cassert>
 #include <sstream>
+#include <stdexcept>
 #include <string_view>
 #include <iomanip>
 
@@ -90,7 +94,7 @@ namespace fa::nfa
 
     bool TransitionsTableVisitor::visitNFA(NFA nfa)
     {
-        this->transitions_table.starting = nfa.in.get();
+        this->transitions_table.starting = nfa.in;
         return true;
     }
 
@@ -152,30 +156,30 @@ namespace fa::nfa
         return os;
     }
 
-    NFA::NFA(std::shared_ptr<State> in, std::shared_ptr<State> out)
-        : in(in), out(out)
+    NFA::NFA(std::shared_ptr<Graph> graph, State* in, State* out)
+        : graph(graph), in(in), out(out)
     {
     }
 
     NFA::NFA(char c)
-        : in(make_shared<State>(false))
-        , out(make_shared<State>(true))
+        : graph(make_shared<Graph>())
+        , in(graph->create_state(false))
+        , out(graph->create_state(true))
     {
-        in->add_transition(string{c}, out);
+        in->add_transition(c, out);
     }
 
     NFA::NFA()
-        : in(make_shared<State>(false))
-        , out(make_shared<State>(true))
+        : graph(make_shared<Graph>())
+        , in(graph->create_state(false))
+        , out(graph->create_state(true))
     {
-        in->add_transition(EPSILON, out);
+        in->add_epsilon_transition(out);
     }
 
-    bool NFA::match(std::string_view input)
+    bool NFA::match(std::string_view input) const
     {
-        (void)input;
-        // TODO return this->in->match(input);
-        return false;
+        return this->find(input).has_value();
     }
 
     /**
@@ -188,12 +192,12 @@ namespace fa::nfa
      */
     NFA NFA::operator+(NFA other)
     {
-        this->out->add_transition(EPSILON, other.in);
+        this->out->add_epsilon_transition(other.in);
 
         this->out->set_accepting(false);
         other.out->set_accepting(true);
 
-        return NFA{this->in, other.out};
+        return NFA{ Graph::merge(this->graph, other.graph), this->in, other.out };
     }
 
     /**
@@ -207,19 +211,21 @@ namespace fa::nfa
      */
     NFA NFA::operator|(NFA other)
     {
-        auto starting_state = make_shared<State>(false);
-        auto accepting_state = make_shared<State>(true);
-        
-        starting_state->add_transition(EPSILON, this->in);
-        starting_state->add_transition(EPSILON, other.in);
+        auto graph = Graph::merge(this->graph, other.graph);
+        auto starting_state = graph->create_state(false);
+        auto accepting_state = graph->create_state(true);
+
 
-        this->out->add_transition(EPSILON, accepting_state);
-        other.out->add_transition(EPSILON, accepting_state);
+        starting_state->add_epsilon_transition(this->in);
+        starting_state->add_epsilon_transition(other.in);
+
+        this->out->add_epsilon_transition(accepting_state);
+        other.out->add_epsilon_transition(accepting_state);
 
         this->out->set_accepting(false);
         other.out->set_accepting(false);
 
-        return NFA{ starting_state,  accepting_state};
+        return NFA{ graph, starting_state, accepting_state };
     }
 
     NFA kleene_naive(NFA a)
@@ -227,16 +233,16 @@ namespace fa::nfa
         // epsilon machine, with in=A, out=B and only transition A -e-> B
         NFA resulting;
 
-        resulting.in->add_transition(EPSILON, a.in);
-        a.out->add_transition(EPSILON, resulting.out);
+        resulting.in->add_epsilon_transition(a.in);
+        a.out->add_epsilon_transition(resulting.out);
 
         a.out->set_accepting(false);
         resulting.out->set_accepting(true);
         
         // loop
-        resulting.out->add_transition(EPSILON, a.in);
+        resulting.out->add_epsilon_transition(a.in);
 
-        return resulting;
+        return NFA{ Graph::merge(resulting.graph, a.graph), resulting.in, resulting.out };
     }
 
     NFA plus_naive(NFA a)
@@ -277,43 +283,182 @@ namespace fa::nfa
         return resulting;
     }
 
+    /**
+     * Whether an epsilon transition from the fragment's in state to its out state only skips whole
+     * matches of it: no inner loop comes back to its in state nor leaves its out state, but its own
+     * out -e-> in loop. Otherwise, (a+b)? would match "a" through a.in -a-> a.out -e-> a.in -e-> out.
+     */
+    static bool can_skip(const NFA& a)
+    {
+        const States& out_epsilons = a.out->get_epsilon_transitions();
+        auto loops = static_cast<uint32_t>(count(out_epsilons.begin(), out_epsilons.end(), a.in));
+        return a.in->get_incoming_count() == loops
+            && out_epsilons.size() == loops
+            && a.out->get_transitions().empty();
+    }
+
+    /**
+     * The fragment, wrapped between fresh in and out states when it can't be skipped as is.
+     */
+    static NFA skippable(NFA a)
+    {
+        if (can_skip(a)) {
+            return a;
+        }
+        // a.graph may have been merged into another one since, which now owns a's states
+        shared_ptr<Graph> graph = Graph::root(a.graph);
+        State* in = graph->create_state(false);
+        State* out = graph->create_state(true);
+        in->add_epsilon_transition(a.in);
+        a.out->add_epsilon_transition(out);
+        a.out->set_accepting(false);
+
+        return NFA{ graph, in, out };
+    }
+
     NFA zeroOrMore(NFA a)
     {
-        a.in->add_transition(EPSILON, a.out);
-        a.out->add_transition(EPSILON, a.in);
+        a = skippable(a);
+        a.in->add_epsilon_transition(a.out);
+        a.out->add_epsilon_transition(a.in);
 
         return a;
     }
 
     NFA oneOrMore(NFA a)
     {
-        a.out->add_transition(EPSILON, a.in);
+        a.out->add_epsilon_transition(a.in);
 
         return a;
     }
 
     NFA opt(NFA a)
     {
-        a.in->add_transition(EPSILON, a.out);
+        a = skippable(a);
+        a.in->add_epsilon_transition(a.out);
 
         return a;
     }
 
     NFA range(char from, char to)
     {
-        assert(from <= to);
+        assert(static_cast<unsigned char>(from) <= static_cast<unsigned char>(to));
 
-        NFA resulting{ from };
-        for (char c = from + 1; c <= to; c++) {
-            resulting.in->add_transition(string{c}, resulting.out);
+        auto graph = make_shared<Graph>();
+        auto in = graph->create_state(false);
+        auto out = graph->create_state(true);
+        in->add_range_transition(from, to, out);
+
+        return NFA{ graph, in, out };
+    }
+
+    vector<pair<unsigned char, unsigned char>> class_intervals(vector<pair<char, char>> ranges, bool negated)
+    {
+        // normalize the ranges: sorted (as bytes) and merged when overlapping or adjacent
+        vector<pair<unsigned, unsigned>> intervals;
+        for (const auto& [from, to]: ranges) {
+            intervals.emplace_back(static_cast<unsigned char>(from), static_cast<unsigned char>(to));
+            assert(intervals.back().first <= intervals.back().second);
         }
+        sort(intervals.begin(), intervals.end());
 
-        return resulting;
+        vector<pair<unsigned, unsigned>> merged;
+        for (const auto& interval: intervals) {
+            if (!merged.empty() && interval.first <= merged.back().second + 1) {
+                merged.back().second = max(merged.back().second, interval.second);
+            } else {
+                merged.push_back(interval);
+            }
+        }
+
+        if (negated) {
+            vector<pair<unsigned, unsigned>> complement;
+            unsigned next = 0;
+            for (const auto& [from, to]: merged) {
+                if (from > next) {
+                    complement.emplace_back(next, from - 1);
+                }
+                next = to + 1;
+            }
+            if (next <= 255) {
+                complement.emplace_back(next, 255);
+            }
+            merged = move(complement);
+        }
+
+        vector<pair<unsigned char, unsigned char>> result;
+        for (const auto& [from, to]: merged) {
+            result.emplace_back(static_cast<unsigned char>(from), static_cast<unsigned char>(to));
+        }
+        return result;
+    }
+
+    NFA char_class(vector<pair<char, char>> ranges, bool negated)
+    {
+        auto graph = make_shared<Graph>();
+        auto in = graph->create_state(false);
+        auto out = graph->create_state(true);
+        for (const auto& [from, to]: class_intervals(move(ranges), negated)) {
+            in->add_range_transition(static_cast<char>(from), static_cast<char>(to), out);
+        }
+
+        return NFA{ graph, in, out };
+    }
+
+    NFA reverse(const NFA& nfa)
+    {
+        auto graph = make_shared<Graph>();
+
+        // clone every state reachable from the input state
+        unordered_map<const State*, State*> clones;
+        vector<const State*> states;
+        vector<const State*> stack{ nfa.in };
+        while (!stack.empty()) {
+            const State* state = stack.back();
+            stack.pop_back();
+            if (clones.count(state) > 0) {
+                continue;
+            }
+            clones.emplace(state, graph->create_state(false));
+            states.push_back(state);
+
+            for (const State* next_state: state->get_epsilon_transitions()) {
+                stack.push_back(next_state);
+            }
+            for (const Transition& transition: state->get_transitions()) {
+                stack.push_back(transition.target);
+            }
+        }
+        assert(clones.count(nfa.out) > 0);
+
+        // the output state becomes the input state. any other accepting state must be reachable from it too
+        State* in = nfa.out->is_accepting() ? clones.at(nfa.out) : graph->create_state(false);
+        State* out = clones.at(nfa.in);
+
+        for (const State* state: states) {
+            State* clone = clones.at(state);
+            for (const State* next_state: state->get_epsilon_transitions()) {
+                clones.at(next_state)->add_epsilon_transition(clone);
+            }
+            for (const Transition& transition: state->get_transitions()) {
+                clones.at(transition.target)->add_range_transition(
+                    static_cast<char>(transition.from),
+                    static_cast<char>(transition.to),
+                    clone
+                );
+            }
+            if (state->is_accepting() && clone != in) {
+                in->add_epsilon_transition(clone);
+            }
+        }
+        out->set_accepting(true);
+
+        return NFA{ graph, in, out };
     }
 
     void NFA::accept(Visitor& visitor) const
     {
-        set<const State*> visited_states;
+        SparseSet visited_states{ Graph::root(this->graph)->get_state_count() };
 
         visitor.visitNFA(*this);
         this->in->accept(visitor, visited_states);
@@ -322,8 +467,151 @@ namespace fa::nfa
 
     bool NFA::matches(string_view input) const
     {
-        set<const State*> visited_states;
+        return Matcher{ *this }.matches(input);
+    }
+
+    optional<Match> NFA::find(string_view input) const
+    {
+        Simulator simulator{ *this };
+
+        return simulator.find(input);
+    }
+
+    Matches<Simulator> NFA::find_all(string_view input) const
+    {
+        return Matches<Simulator>{ Simulator{ *this }, input };
+    }
+
+    /**
+     * The states reachable from the input state of a fragment, plus its output state.
+     */
+    static vector<State*> fragment_states(const NFA& nfa)
+    {
+        SparseSet visited{ Graph::root(nfa.graph)->get_state_count() };
+        vector<State*> states;
+        vector<State*> stack{ nfa.out, nfa.in };
+        while (!stack.empty()) {
+            State* state = stack.back();
+            stack.pop_back();
+            if (!visited.insert(state->get_id())) {
+                continue;
+            }
+            states.push_back(state);
+            for (State* next_state: state->get_epsilon_transitions()) {
+                stack.push_back(next_state);
+            }
+            for (const Transition& transition: state->get_transitions()) {
+                stack.push_back(transition.target);
+            }
+        }
+        return states;
+    }
+
+    /**
+     * The index of each of the given states (by id) in the vector, sized to the states rather than
+     * to their graph, so repeat can clone a small fragment many times in linear time.
+     */
+    static unordered_map<uint32_t, size_t> state_indexes(const vector<State*>& states)
+    {
+        unordered_map<uint32_t, size_t> indexes;
+        indexes.reserve(states.size());
+        for (size_t i = 0; i < states.size(); i++) {
+            indexes.emplace(states[i]->get_id(), i);
+        }
+        return indexes;
+    }
+
+    /**
+     * Clones the given states (of the given graph), returning the clone of each state at its index.
+     */
+    static vector<State*> clone_states(Graph& graph, const vector<State*>& states, const unordered_map<uint32_t, size_t>& indexes)
+    {
+        vector<State*> clones;
+        clones.reserve(states.size());
+        for (const State* state: states) {
+            clones.push_back(graph.create_state(state->is_accepting()));
+        }
+        for (size_t i = 0; i < states.size(); i++) {
+            for (const State* next_state: states[i]->get_epsilon_transitions()) {
+                clones[i]->add_epsilon_transition(clones[indexes.at(next_state->get_id())]);
+            }
+            // already sorted, so every transition just goes at the end
+            for (const Transition& transition: states[i]->get_transitions()) {
+                clones[i]->add_range_transition(
+                    static_cast<char>(transition.from),
+                    static_cast<char>(transition.to),
+                    clones[indexes.at(transition.target->get_id())]
+                );
+            }
+        }
+        return clones;
+    }
+
+    NFA clone(const NFA& nfa)
+    {
+        shared_ptr<Graph> graph = Graph::root(nfa.graph);
+        const vector<State*> states = fragment_states(nfa);
+        const unordered_map<uint32_t, size_t> indexes = state_indexes(states);
+        vector<State*> clones = clone_states(*graph, states, indexes);
+
+        return NFA{ graph, clones[indexes.at(nfa.in->get_id())], clones[indexes.at(nfa.out->get_id())] };
+    }
+
+    NFA repeat(NFA a, size_t min, size_t max, size_t max_state_count)
+    {
+        assert(min <= max);
+
+        shared_ptr<Graph> graph = Graph::root(a.graph);
+        if (max == 0) {
+            State* in = graph->create_state(false);
+            State* out = graph->create_state(true);
+            in->add_epsilon_transition(out);
+            return NFA{ graph, in, out };
+        }
+        if (min == 0 && max == UNBOUNDED) {
+            return zeroOrMore(a);
+        }
+
+        // the optional copies are skipped
+        if (max != UNBOUNDED) {
+            a = skippable(a);
+        }
+
+        // the fragment itself is the first copy
+        const size_t copy_count = max == UNBOUNDED ? min : max;
+        const vector<State*> states = fragment_states(a);
+        if (copy_count > max_state_count / states.size()) {
+            throw length_error{
+                "repetition needs more than " + to_string(max_state_count) + " states"
+            };
+        }
+
+        // clone before linking the copies, so clones don't follow the links
+        const unordered_map<uint32_t, size_t> indexes = state_indexes(states);
+        const size_t in_index = indexes.at(a.in->get_id());
+        const size_t out_index = indexes.at(a.out->get_id());
+        vector<NFA> copies{ a };
+        copies.reserve(copy_count);
+        for (size_t i = 1; i < copy_count; i++) {
+            vector<State*> clones = clone_states(*graph, states, indexes);
+            copies.push_back(NFA{ graph, clones[in_index], clones[out_index] });
+        }
+
+        for (size_t i = 0; i + 1 < copies.size(); i++) {
+            copies[i].out->add_epsilon_transition(copies[i + 1].in);
+            copies[i].out->set_accepting(false);
+        }
+        State* out = copies.back().out;
+        out->set_accepting(true);
+
+        if (max == UNBOUNDED) {
+            out->add_epsilon_transition(copies.back().in);
+        } else {
+            for (size_t i = min; i < copies.size(); i++) {
+                copies[i].in->add_epsilon_transition(out);
+            }
+        }
 
-        return this->in->matches(visited_states, input);
+        return NFA{ graph, a.in, out };
     }
 }
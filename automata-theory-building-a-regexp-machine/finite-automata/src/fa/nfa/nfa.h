@@ -1,11 +1,18 @@
 #ifndef FA_NFA_H
 #define FA_NFA_H
 
+#include <cstdint>
 #include <memory>
 #include <set>
 #include <map>
+#include <optional>
 #include <string_view>
+#include <utility>
+#include <vector>
 
+#include <fa/match.h>
+
+#include "graph.h"
 #include "state.h"
 
 namespace fa::nfa
@@ -13,6 +20,7 @@ namespace fa::nfa
     #define EPSILON ""
 
     class NFA;
+    class Simulator;
 
     class Visitor
     {
@@ -73,19 +81,23 @@ namespace fa::nfa
      * The basic building block for creating Nondeterministic Finite Automatas (NFA).
      * 
      * A NFA Fragment models only one input state and an output state.
+     *
+     * The states themselves are owned by the fragment's Graph. Composing fragments merges
+     * their graphs, so the resulting fragment owns all states it is made of.
      * 
      * TODO rename this to Fragment maybe. Analyze later if this makes sense...
      */
     class NFA {
     public:
-        std::shared_ptr<State> in;
-        std::shared_ptr<State> out;
+        std::shared_ptr<Graph> graph;
+        State* in;
+        State* out;
         /**
          * Standard generic constructor.
          * 
-         * Just creates a new NFA with the given input and output states.
+         * Just creates a new NFA with the given input and output states, owned by the given graph.
          */
-        NFA(std::shared_ptr<State> in, std::shared_ptr<State> out);
+        NFA(std::shared_ptr<Graph> graph, State* in, State* out);
 
         /**
          * Single character (byte) constructor.
@@ -112,10 +124,10 @@ namespace fa::nfa
         NFA();
 
         /**
-         * Verifies if the given input matches this NFA.
+         * Verifies if this NFA matches anywhere inside the given input.
          */
         [[nodiscard]]
-        bool match(std::string_view input);
+        bool match(std::string_view input) const;
 
         /**
          * Concatenation composition operator
@@ -142,6 +154,9 @@ namespace fa::nfa
          * Just adds two epsilon transitions:
          *    A.in  -e-> A.out , and
          *    A.out -e-> A.in
+         *
+         * A is first wrapped between two new states if an inner loop comes back to A.in or
+         * leaves A.out (as in (a+b)*), so skipping it can't skip half a match.
          */
         friend NFA zeroOrMore(NFA a);
 
@@ -155,13 +170,38 @@ namespace fa::nfa
         /**
          * Optimal question mark '?' (optional) operator.
          * 
-         * Just adds an epsilon transition from A.in to A.out.
+         * Just adds an epsilon transition from A.in to A.out (after wrapping A between two
+         * new states if needed, see zeroOrMore).
          */
         friend NFA opt(NFA a);
 
         void accept(Visitor& visitor) const;
 
+        /**
+         * Verifies if the whole given input matches this NFA.
+         *
+         * A convenience for one-off checks: every call builds a Matcher (the bit-parallel ShiftAnd
+         * when the NFA fits in it, or the NFA Simulator otherwise), before matching linearly on the
+         * input size. Keep it out of hot paths: when matching many inputs against the same NFA,
+         * build a Matcher (or a dfa::Table) once and reuse it.
+         */
         bool matches(std::string_view input) const;
+
+        /**
+         * Searches the leftmost-longest match of this NFA inside the given input.
+         *
+         * Runs the NFA Simulator in a single pass over the input.
+         */
+        [[nodiscard]]
+        std::optional<fa::Match> find(std::string_view input) const;
+
+        /**
+         * All non-overlapping matches of this NFA inside the given input, from left to right.
+         *
+         * Iterating it requires including <fa/nfa/simulator.h>.
+         */
+        [[nodiscard]]
+        fa::Matches<Simulator> find_all(std::string_view input) const;
     };
 
     /**
@@ -209,9 +249,69 @@ namespace fa::nfa
     /**
      * Optimal character class (range) pattern.
      * 
-     * Just union these sanely with only transitions, without more states.
+     * Just a single interval transition [from-to], without more states.
      */
     NFA range(char from, char to);
+
+    /**
+     * Optimal general character class pattern, like [a-z0-9_] or [^\n].
+     *
+     * The ranges are sorted and merged (and complemented when negated), so the fragment
+     * has a single interval transition per resulting range, regardless of how many
+     * characters they contain.
+     */
+    NFA char_class(std::vector<std::pair<char, char>> ranges, bool negated = false);
+
+    /**
+     * The sorted, disjoint byte intervals of the given character class (see char_class).
+     */
+    [[nodiscard]]
+    std::vector<std::pair<unsigned char, unsigned char>> class_intervals(
+        std::vector<std::pair<char, char>> ranges,
+        bool negated = false
+    );
+
+    /**
+     * Reverse NFA.
+     *
+     * Builds a new NFA (on its own graph) with every transition reversed and the input and
+     * output states swapped, so it matches exactly the reversed strings matched by the given NFA.
+     */
+    NFA reverse(const NFA& nfa);
+
+    /**
+     * Deep copy of a NFA fragment.
+     *
+     * Copying a NFA by value just copies its input and output state pointers, so both copies share
+     * (and keep modifying) the very same states. The clone gets its own copy of every state reachable
+     * from the input state (plus the output state), created in the same graph, so it can be composed
+     * with the original without merging graphs.
+     */
+    [[nodiscard]]
+    NFA clone(const NFA& nfa);
+
+    /**
+     * Upper bound for the repeat's max count: a{n,}.
+     */
+    constexpr size_t UNBOUNDED = SIZE_MAX;
+
+    /**
+     * Default limit on the number of states a repeat may create.
+     */
+    constexpr size_t DEFAULT_MAX_STATE_COUNT = 1 << 20;
+
+    /**
+     * Counted repetition: a{min,max}.
+     *
+     * The fragment is followed by max - 1 clones of itself (or min clones when max is UNBOUNDED, the
+     * last one looping). The first min copies are mandatory, and the input state of every optional
+     * copy also skips straight to the output, so a{n,m} is a{n}(a(a(...)?)?)? with a linear number
+     * of states and transitions.
+     *
+     * Throws std::length_error, before creating any state, when the repetition would need more than
+     * max_state_count states.
+     */
+    NFA repeat(NFA a, size_t min, size_t max = UNBOUNDED, size_t max_state_count = DEFAULT_MAX_STATE_COUNT);
 }
 
 #endif
@@ -0,0 +1,381 @@
+#include "parser.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace fa::nfa
+{
+    SyntaxError::SyntaxError(const string& message, size_t position)
+        : invalid_argument(message + " at position " + to_string(position))
+        , position(position)
+    {
+    }
+
+    size_t SyntaxError::get_position() const
+    {
+        return this->position;
+    }
+
+    /**
+     * Recursive descent parser, building Thompson fragments in a single graph:
+     *
+     *     alternation   := concatenation ('|' concatenation)*
+     *     concatenation := repetition*
+     *     repetition    := atom ('*' | '+' | '?' | '{' count (',' count?)? '}')*
+     *     atom          := '(' alternation ')' | '[' class ']' | '.' | '\' escape | byte
+     */
+    class Parser
+    {
+    protected:
+        using Intervals = vector<pair<char, char>>;
+
+        struct Fragment {
+            State* in;
+            State* out;
+        };
+
+        string_view pattern;
+        size_t position = 0;
+        size_t depth = 0;
+        size_t max_state_count;
+        shared_ptr<Graph> graph;
+
+        [[noreturn]]
+        void fail(const string& message) const
+        {
+            throw SyntaxError{ message, this->position };
+        }
+
+        [[nodiscard]]
+        bool at_end() const
+        {
+            return this->position == this->pattern.size();
+        }
+
+        [[nodiscard]]
+        char peek() const
+        {
+            return this->pattern[this->position];
+        }
+
+        Fragment epsilon()
+        {
+            Fragment fragment{ this->graph->create_state(), this->graph->create_state() };
+            fragment.in->add_epsilon_transition(fragment.out);
+            return fragment;
+        }
+
+        Fragment symbol(const Intervals& ranges, bool negated = false)
+        {
+            Fragment fragment{ this->graph->create_state(), this->graph->create_state() };
+            if (ranges.size() == 1 && !negated) {
+                fragment.in->add_range_transition(ranges[0].first, ranges[0].second, fragment.out);
+                return fragment;
+            }
+            for (const auto& [from, to]: class_intervals(ranges, negated)) {
+                fragment.in->add_range_transition(static_cast<char>(from), static_cast<char>(to), fragment.out);
+            }
+            return fragment;
+        }
+
+        /**
+         * The intervals of a \d, \w or \s class escape (or its negation), if c is one.
+         */
+        static bool class_escape(char c, Intervals& ranges, bool& negated)
+        {
+            switch (c) {
+            case 'd': case 'D':
+                ranges = { {'0', '9'} };
+                break;
+            case 'w': case 'W':
+                ranges = { {'a', 'z'}, {'A', 'Z'}, {'0', '9'}, {'_', '_'} };
+                break;
+            case 's': case 'S':
+                ranges = { {' ', ' '}, {'\t', '\r'} };
+                break;
+            default:
+                return false;
+            }
+            negated = c >= 'A' && c <= 'Z';
+            return true;
+        }
+
+        /**
+         * The byte of a (non class) escape sequence, after the backslash.
+         */
+        char escaped_byte(char c) const
+        {
+            switch (c) {
+            case 'n': return '\n';
+            case 't': return '\t';
+            case 'r': return '\r';
+            case 'f': return '\f';
+            case 'v': return '\v';
+            default:
+                break;
+            }
+            if (string_view{ "\\|()[]{}*+?.^$-/" }.find(c) == string_view::npos) {
+                this->fail(string{ "unknown escape \\" } + c);
+            }
+            return c;
+        }
+
+        Fragment alternation()
+        {
+            Fragment fragment = this->concatenation();
+            if (this->at_end() || this->peek() != '|') {
+                return fragment;
+            }
+
+            // like NFA::operator|, but a single pair of states for all alternatives
+            Fragment resulting{ this->graph->create_state(), this->graph->create_state() };
+            resulting.in->add_epsilon_transition(fragment.in);
+            fragment.out->add_epsilon_transition(resulting.out);
+            while (!this->at_end() && this->peek() == '|') {
+                this->position++;
+                fragment = this->concatenation();
+                resulting.in->add_epsilon_transition(fragment.in);
+                fragment.out->add_epsilon_transition(resulting.out);
+            }
+            return resulting;
+        }
+
+        Fragment concatenation()
+        {
+            if (this->at_end() || this->peek() == '|' || this->peek() == ')') {
+                return this->epsilon();
+            }
+
+            Fragment resulting = this->repetition();
+            while (!this->at_end() && this->peek() != '|' && this->peek() != ')') {
+                Fragment fragment = this->repetition();
+                resulting.out->add_epsilon_transition(fragment.in);
+                resulting.out = fragment.out;
+            }
+            return resulting;
+        }
+
+        Fragment repetition()
+        {
+            Fragment fragment = this->atom();
+            while (!this->at_end()) {
+                char c = this->peek();
+                if (c == '*' || c == '+' || c == '?') {
+                    // the operators wrap the fragment when skipping it as is would skip half a match
+                    NFA nfa{ this->graph, fragment.in, fragment.out };
+                    nfa = c == '*' ? zeroOrMore(nfa) : c == '+' ? oneOrMore(nfa) : opt(nfa);
+                    // only the output of the whole pattern is accepting
+                    nfa.out->set_accepting(false);
+                    fragment = Fragment{ nfa.in, nfa.out };
+                } else if (c == '{') {
+                    fragment = this->counted_repetition(fragment);
+                    continue;
+                } else {
+                    break;
+                }
+                this->position++;
+            }
+            return fragment;
+        }
+
+        size_t count()
+        {
+            if (this->at_end() || this->peek() < '0' || this->peek() > '9') {
+                this->fail("expected a repetition count");
+            }
+            size_t count = 0;
+            while (!this->at_end() && this->peek() >= '0' && this->peek() <= '9') {
+                count = count * 10 + static_cast<size_t>(this->peek() - '0');
+                if (count > this->max_state_count) {
+                    this->fail("repetition count too big");
+                }
+                this->position++;
+            }
+            return count;
+        }
+
+        Fragment counted_repetition(Fragment fragment)
+        {
+            size_t start = this->position++;
+            size_t min_count = this->count();
+            size_t max_count = min_count;
+            if (!this->at_end() && this->peek() == ',') {
+                this->position++;
+                max_count = !this->at_end() && this->peek() == '}' ? UNBOUNDED : this->count();
+            }
+            if (this->at_end() || this->peek() != '}') {
+                this->fail("missing }");
+            }
+            this->position++;
+            if (min_count > max_count) {
+                this->position = start;
+                this->fail("invalid repetition bounds");
+            }
+
+            NFA nfa{ this->graph, fragment.in, fragment.out };
+            // the states created so far count against the limit too
+            size_t state_count = min(this->graph->get_state_count(), this->max_state_count);
+            try {
+                nfa = repeat(nfa, min_count, max_count, this->max_state_count - state_count);
+            } catch (const length_error&) {
+                this->position = start;
+                this->fail("repetition needs more than " + to_string(this->max_state_count) + " states");
+            }
+            // only the output of the whole pattern is accepting
+            nfa.out->set_accepting(false);
+
+            return Fragment{ nfa.in, nfa.out };
+        }
+
+        Fragment atom()
+        {
+            char c = this->peek();
+            switch (c) {
+            case '(': {
+                if (++this->depth > MAX_GROUP_DEPTH) {
+                    this->fail("too many nested groups");
+                }
+                this->position++;
+                Fragment fragment = this->alternation();
+                if (this->at_end()) {
+                    this->fail("missing )");
+                }
+                this->position++;
+                this->depth--;
+                return fragment;
+            }
+            case '[':
+                this->position++;
+                return this->bracket_class();
+            case '.':
+                this->position++;
+                return this->symbol({ {'\n', '\n'} }, true);
+            case '\\': {
+                this->position++;
+                if (this->at_end()) {
+                    this->fail("trailing \\");
+                }
+                Intervals ranges;
+                bool negated = false;
+                c = this->pattern[this->position];
+                if (!class_escape(c, ranges, negated)) {
+                    c = this->escaped_byte(c);
+                    ranges = { {c, c} };
+                }
+                this->position++;
+                return this->symbol(ranges, negated);
+            }
+            case '*': case '+': case '?': case '{':
+                this->fail(string{ "nothing to repeat before " } + c);
+            case ')':
+                this->fail("unmatched )");
+            case ']':
+                this->fail("unmatched ]");
+            default:
+                this->position++;
+                return this->symbol({ {c, c} });
+            }
+        }
+
+        /**
+         * A class byte, handling escapes (c is the byte at the current position).
+         */
+        char class_byte()
+        {
+            char c = this->pattern[this->position++];
+            if (c != '\\') {
+                return c;
+            }
+            if (this->at_end()) {
+                this->fail("trailing \\");
+            }
+            return this->escaped_byte(this->pattern[this->position++]);
+        }
+
+        Fragment bracket_class()
+        {
+            size_t start = this->position - 1;
+            bool negated = false;
+            if (!this->at_end() && this->peek() == '^') {
+                negated = true;
+                this->position++;
+            }
+
+            Intervals ranges;
+            bool first = true;
+            while (true) {
+                if (this->at_end()) {
+                    this->position = start;
+                    this->fail("missing ]");
+                }
+                char c = this->peek();
+                if (c == ']' && !first) {
+                    this->position++;
+                    break;
+                }
+                first = false;
+
+                if (c == '\\' && this->position + 1 < this->pattern.size()) {
+                    Intervals escape_ranges;
+                    bool escape_negated = false;
+                    if (class_escape(this->pattern[this->position + 1], escape_ranges, escape_negated)) {
+                        if (escape_negated) {
+                            for (const auto& [from, to]: class_intervals(escape_ranges, true)) {
+                                ranges.emplace_back(static_cast<char>(from), static_cast<char>(to));
+                            }
+                        } else {
+                            ranges.insert(ranges.end(), escape_ranges.begin(), escape_ranges.end());
+                        }
+                        this->position += 2;
+                        continue;
+                    }
+                }
+
+                char from = this->class_byte();
+                char to = from;
+                bool is_range = this->position + 1 < this->pattern.size()
+                    && this->peek() == '-'
+                    && this->pattern[this->position + 1] != ']';
+                if (is_range) {
+                    this->position++;
+                    to = this->class_byte();
+                    if (static_cast<unsigned char>(from) > static_cast<unsigned char>(to)) {
+                        this->fail("invalid class range");
+                    }
+                }
+                ranges.emplace_back(from, to);
+            }
+
+            return this->symbol(ranges, negated);
+        }
+
+    public:
+        Parser(string_view pattern, size_t max_state_count)
+            : pattern(pattern)
+            , max_state_count(max_state_count)
+            , graph(make_shared<Graph>())
+        {
+        }
+
+        NFA parse()
+        {
+            Fragment fragment = this->alternation();
+            if (!this->at_end()) {
+                // alternation only stops early at a )
+                this->fail("unmatched )");
+            }
+            fragment.out->set_accepting(true);
+
+            return NFA{ this->graph, fragment.in, fragment.out };
+        }
+    };
+
+    NFA compile(string_view pattern, size_t max_state_count)
+    {
+        return Parser{ pattern, max_state_count }.parse();
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef FA_NFA_PARSER_H
+#define FA_NFA_PARSER_H
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "nfa.h"
+
+namespace fa::nfa
+{
+    /**
+     * Invalid pattern syntax, with the position (byte offset) in the pattern where it was found.
+     */
+    class SyntaxError: public std::invalid_argument
+    {
+    protected:
+        size_t position;
+
+    public:
+        SyntaxError(const std::string& message, size_t position);
+
+        // GETTERS
+
+        [[nodiscard]]
+        size_t get_position() const;
+    };
+
+    /**
+     * Maximum nesting of groups in a pattern, so parsing can't overflow the call stack.
+     */
+    constexpr size_t MAX_GROUP_DEPTH = 1000;
+
+    /**
+     * Compiles a pattern string into a NFA.
+     *
+     * Supported syntax:
+     *
+     * - literal bytes, and `\` escaping any of the special characters `\ | ( ) [ ] { } * + ? . ^ $ -`
+     * - `\n`, `\t`, `\r`, `\f`, `\v` control characters
+     * - `.` any byte but `\n`
+     * - `\d`, `\w`, `\s` (digits, word and space characters) and their negations `\D`, `\W`, `\S`
+     * - classes like `[a-z_]` and negated classes like `[^0-9]`, which may contain the above escapes.
+     *   A `]` right after the `[` (or `[^`) and a `-` at either end are literal.
+     * - concatenation, `|` union and `(...)` groups. An empty alternative matches the empty string.
+     * - `*`, `+` and `?` repetitions
+     * - `{n}`, `{n,}` and `{n,m}` counted repetitions (see repeat)
+     *
+     * The states go straight into a single Graph, with the same Thompson constructions as the NFA
+     * combinators but no intermediate fragment (nor graph merge) per symbol or operator.
+     *
+     * Throws SyntaxError for invalid patterns, including the ones needing more than max_state_count states.
+     */
+    [[nodiscard]]
+    NFA compile(std::string_view pattern, size_t max_state_count = DEFAULT_MAX_STATE_COUNT);
+}
+
+#endif
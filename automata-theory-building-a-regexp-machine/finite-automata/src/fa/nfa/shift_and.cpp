@@ -0,0 +1,92 @@
+#include "shift_and.h"
+
+#include <cassert>
+
+using namespace std;
+
+namespace fa::nfa
+{
+    bool ShiftAnd::fits(const Automaton& automaton)
+    {
+        if (automaton.get_state_count() > MAX_STATE_COUNT) {
+            return false;
+        }
+        for (uint32_t state = 0; state < automaton.get_state_count(); state++) {
+            for (const auto& edge: automaton.get_transitions(state)) {
+                if (edge.target != state + 1) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    ShiftAnd::ShiftAnd(const Automaton& automaton)
+        : closure_masks((automaton.get_state_count() + 7) / 8)
+    {
+        assert(fits(automaton));
+
+        const size_t state_count = automaton.get_state_count();
+        vector<uint64_t> closures(state_count, 0);
+        for (uint32_t state = 0; state < state_count; state++) {
+            vector<uint32_t> stack{ state };
+            while (!stack.empty()) {
+                uint32_t closed_state = stack.back();
+                stack.pop_back();
+                if ((closures[state] >> closed_state) & 1) {
+                    continue;
+                }
+                closures[state] |= uint64_t{ 1 } << closed_state;
+                for (uint32_t next_state: automaton.get_epsilon_transitions(closed_state)) {
+                    stack.push_back(next_state);
+                }
+            }
+
+            if (automaton.is_accepting(state)) {
+                this->accepting_states |= uint64_t{ 1 } << state;
+            }
+            for (const auto& edge: automaton.get_transitions(state)) {
+                for (size_t c = edge.from; c <= edge.to; c++) {
+                    this->byte_masks[c] |= uint64_t{ 1 } << state;
+                }
+            }
+        }
+
+        for (size_t chunk = 0; chunk < this->closure_masks.size(); chunk++) {
+            for (size_t bits = 0; bits < 256; bits++) {
+                uint64_t closure = 0;
+                for (size_t i = 0; i < 8 && chunk * 8 + i < state_count; i++) {
+                    if ((bits >> i) & 1) {
+                        closure |= closures[chunk * 8 + i];
+                    }
+                }
+                this->closure_masks[chunk][bits] = closure;
+            }
+        }
+
+        this->starting_states = closures[automaton.get_starting_state()];
+    }
+
+    uint64_t ShiftAnd::close(uint64_t states) const
+    {
+        uint64_t closure = 0;
+        for (const auto& masks: this->closure_masks) {
+            closure |= masks[states & 0xff];
+            states >>= 8;
+        }
+        return closure;
+    }
+
+    bool ShiftAnd::matches(string_view input) const
+    {
+        uint64_t states = this->starting_states;
+        for (unsigned char c: input) {
+            // byte transitions go from s to s + 1 (the last state has none, so nothing shifts out)
+            states = this->close((states & this->byte_masks[c]) << 1);
+            if (states == 0) {
+                return false;
+            }
+        }
+        return (states & this->accepting_states) != 0;
+    }
+}
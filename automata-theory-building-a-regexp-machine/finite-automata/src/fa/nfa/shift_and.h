@@ -0,0 +1,63 @@
+#ifndef FA_NFA_SHIFT_AND_H
+#define FA_NFA_SHIFT_AND_H
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "automaton.h"
+
+namespace fa::nfa
+{
+    /**
+     * Bit-parallel (Shift-And) NFA Simulator.
+     *
+     * For automata of up to 64 states, the whole set of active states fits in a single `uint64_t`.
+     * When every byte transition goes from a state to the next one (state `s` to `s + 1`, which
+     * holds for the Thompson fragments, as their input and output states are created one after the
+     * other), reading a byte `c` is just:
+     *
+     *     active = closure((active & byte_masks[c]) << 1)
+     *
+     * where `byte_masks[c]` are the states with a transition on `c`. The epsilon closure is looked
+     * up 8 states at a time, in one precomputed table per byte of the state set.
+     *
+     * Matching never allocates and takes a few AND/OR/shift operations per input byte.
+     */
+    class ShiftAnd
+    {
+    public:
+        static constexpr size_t MAX_STATE_COUNT = 64;
+
+    protected:
+        uint64_t starting_states = 0;
+        uint64_t accepting_states = 0;
+        std::array<uint64_t, 256> byte_masks = {};
+        // closure_masks[i][b]: epsilon closure of the states 8*i + j for every bit j set in b
+        std::vector<std::array<uint64_t, 256>> closure_masks;
+
+        [[nodiscard]]
+        uint64_t close(uint64_t states) const;
+
+    public:
+        /**
+         * Verifies if the given automaton is small enough and all its byte transitions go to the next state.
+         */
+        [[nodiscard]]
+        static bool fits(const Automaton& automaton);
+
+        /**
+         * Builds the masks for the given automaton, which must fit (see fits()).
+         */
+        explicit ShiftAnd(const Automaton& automaton);
+
+        /**
+         * Verifies if the whole given input matches the automaton.
+         */
+        [[nodiscard]]
+        bool matches(std::string_view input) const;
+    };
+}
+
+#endif
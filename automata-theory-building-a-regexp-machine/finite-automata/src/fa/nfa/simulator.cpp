@@ -0,0 +1,130 @@
+#include "simulator.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace fa::nfa
+{
+    Simulator::Simulator(const NFA& nfa)
+        : Simulator(Automaton{ nfa }.without_epsilons())
+    {
+    }
+
+    Simulator::Simulator(Automaton automaton)
+        : automaton(move(automaton))
+        , current_starts(this->automaton.get_state_count(), 0)
+        , next_starts(this->automaton.get_state_count(), 0)
+        , listed_states(this->automaton.get_state_count())
+    {
+        this->current_states.reserve(this->automaton.get_state_count());
+        this->next_states.reserve(this->automaton.get_state_count());
+    }
+
+    void Simulator::add_state(vector<uint32_t>& states, vector<size_t>& starts, uint32_t state, size_t start)
+    {
+        // explicit stack instead of recursion, so deep epsilon chains can't overflow the call stack
+        this->stack.push_back(state);
+        while (!this->stack.empty()) {
+            uint32_t s = this->stack.back();
+            this->stack.pop_back();
+
+            if (!this->listed_states.insert(s)) {
+                continue;
+            }
+            states.push_back(s);
+            starts[s] = start;
+
+            for (uint32_t next_state: this->automaton.get_epsilon_transitions(s)) {
+                this->stack.push_back(next_state);
+            }
+        }
+    }
+
+    void Simulator::step(unsigned char c, size_t max_start)
+    {
+        this->listed_states.clear();
+        this->next_states.clear();
+
+        // states are listed in increasing start order, so when two match attempts reach the same
+        // state, the leftmost one gets there first and wins
+        for (uint32_t state: this->current_states) {
+            size_t start = this->current_starts[state];
+            if (start > max_start) {
+                continue;
+            }
+            // edges are sorted by interval start, so we can stop at the first one starting after c
+            for (const auto& edge: this->automaton.get_transitions(state)) {
+                if (edge.from > c) {
+                    break;
+                }
+                if (edge.to >= c) {
+                    this->add_state(this->next_states, this->next_starts, edge.target, start);
+                }
+            }
+        }
+        swap(this->current_states, this->next_states);
+        swap(this->current_starts, this->next_starts);
+    }
+
+    void Simulator::reset(size_t start)
+    {
+        this->listed_states.clear();
+        this->current_states.clear();
+        this->add_state(this->current_states, this->current_starts, this->automaton.get_starting_state(), start);
+    }
+
+    bool Simulator::matches(string_view input)
+    {
+        this->reset(0);
+
+        for (unsigned char c: input) {
+            if (this->current_states.empty()) {
+                return false;
+            }
+            this->step(c);
+        }
+
+        return any_of(
+            this->current_states.begin(),
+            this->current_states.end(),
+            [this](uint32_t state) { return this->automaton.is_accepting(state); }
+        );
+    }
+
+    optional<Match> Simulator::find(string_view input, size_t from)
+    {
+        optional<Match> best;
+
+        this->listed_states.clear();
+        this->current_states.clear();
+
+        for (size_t i = from; ; i++) {
+            // Seeding a new match attempt at each position is the implicit `.*` prefix. Once we have a match,
+            // attempts starting later can't be leftmost anymore.
+            if (!best) {
+                uint32_t starting_state = this->automaton.get_starting_state();
+                if (!this->listed_states.contains(starting_state)) {
+                    this->add_state(this->current_states, this->current_starts, starting_state, i);
+                }
+            }
+
+            for (uint32_t state: this->current_states) {
+                if (!this->automaton.is_accepting(state)) {
+                    continue;
+                }
+                size_t start = this->current_starts[state];
+                if (!best || start < best->start || (start == best->start && i > best->end)) {
+                    best = Match{ start, i };
+                }
+            }
+
+            if (i == input.size() || (best && this->current_states.empty())) {
+                break;
+            }
+            this->step(static_cast<unsigned char>(input[i]), best ? best->start : SIZE_MAX);
+        }
+
+        return best;
+    }
+}
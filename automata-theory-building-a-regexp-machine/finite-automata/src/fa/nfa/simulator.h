@@ -0,0 +1,83 @@
+#ifndef FA_NFA_SIMULATOR_H
+#define FA_NFA_SIMULATOR_H
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include <fa/match.h>
+#include <fa/sparse_set.h>
+
+#include "automaton.h"
+#include "nfa.h"
+
+namespace fa::nfa
+{
+    /**
+     * NFA Simulator.
+     *
+     * Thompson's simulation of a NFA. Instead of backtracking over every possible path, the whole
+     * set of active states is advanced at once for each input byte. Every state is added at most
+     * once per input byte, so matching is O(n*m) (input size * number of states), it is not
+     * recursive and the memory used is bounded by the number of states.
+     *
+     * Searching (find) follows Pike's extension: every active state also tracks where the match
+     * it belongs to started, and a new match attempt is started at every input position (an
+     * implicit `.*` prefix). When two attempts reach the same state, the leftmost one wins, so
+     * the whole search is still a single pass over the input.
+     *
+     * The simulator keeps its scratch state lists, so it is cheaper to reuse it across matches.
+     */
+    class Simulator
+    {
+    protected:
+        Automaton automaton;
+        std::vector<uint32_t> current_states;
+        std::vector<uint32_t> next_states;
+        // where the match attempt of each listed state started (indexed by state)
+        std::vector<size_t> current_starts;
+        std::vector<size_t> next_starts;
+        std::vector<uint32_t> stack;
+        // the states of the list being built
+        fa::SparseSet listed_states;
+
+        /**
+         * Adds the given state and its whole epsilon closure to the states list, recording
+         * where their match attempt started.
+         */
+        void add_state(std::vector<uint32_t>& states, std::vector<size_t>& starts, uint32_t state, size_t start);
+
+        /**
+         * Advances all current states reading the given input byte.
+         *
+         * States whose match attempt started after max_start are dropped.
+         */
+        void step(unsigned char c, size_t max_start = SIZE_MAX);
+
+        /**
+         * Clears the current states list and starts over from the starting state.
+         */
+        void reset(size_t start);
+
+    public:
+        Simulator(const NFA& nfa);
+
+        Simulator(Automaton automaton);
+
+        /**
+         * Verifies if the whole given input matches the simulated NFA.
+         */
+        [[nodiscard]]
+        bool matches(std::string_view input);
+
+        /**
+         * Searches the leftmost-longest match of the simulated NFA inside the input,
+         * starting at or after the given position.
+         */
+        [[nodiscard]]
+        std::optional<fa::Match> find(std::string_view input, size_t from = 0);
+    };
+}
+
+#endif
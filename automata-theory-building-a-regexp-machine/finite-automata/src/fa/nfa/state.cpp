@@ -1,6 +1,7 @@
 #include "state.h"
 
-#include <map>
+#include <algorithm>
+#include <cassert>
 #include <iostream>
 
 #include "nfa.h"
@@ -14,139 +15,129 @@ namespace fa::nfa
     {
     }
 
-    void State::add_transition(const string& symbol, std::shared_ptr<State> state)
+    void State::add_transition(const string& symbol, State* state)
     {
-        this->transitions[symbol].push_back(state);
+        assert(symbol.size() <= 1);
+
+        if (symbol == EPSILON) {
+            this->add_epsilon_transition(state);
+        } else {
+            this->add_transition(symbol.front(), state);
+        }
     }
 
-    optional<States> State::get_transitions(const string& symbol) const
+    void State::add_transition(char symbol, State* state)
     {
-        const auto states = this->transitions.find(symbol);
-        if (states == this->transitions.end()) {
-            return nullopt;
-        }
+        this->add_range_transition(symbol, symbol, state);
+    }
 
-        return optional{ states->second };
+    void State::add_range_transition(char from, char to, State* state)
+    {
+        Transition transition{ static_cast<unsigned char>(from), static_cast<unsigned char>(to), state };
+        assert(transition.from <= transition.to);
+
+        // keep transitions sorted by interval start (and by insertion order for the same start)
+        auto it = upper_bound(
+            this->transitions.begin(),
+            this->transitions.end(),
+            transition,
+            [](const Transition& a, const Transition& b) { return a.from < b.from; }
+        );
+        this->transitions.insert(it, transition);
+        state->incoming_count++;
     }
 
-    void State::accept(Visitor& visitor, std::set<const State*>& visited_states) const
+    void State::add_epsilon_transition(State* state)
     {
-        if (visited_states.find(this) != visited_states.end()) {
+        this->epsilon_transitions.push_back(state);
+        state->incoming_count++;
+    }
+
+    void State::accept(Visitor& visitor, SparseSet& visited_states) const
+    {
+        if (!visited_states.insert(this->id)) {
             return;
         }
 
         visitor.visitState(this);
-        visited_states.insert(this);
 
         // We visit all states first then the transitions just because
         // It's useful (at least for the GraphDumpVisitor) to know visited
         // states before dealing with visited transitions
-        for (const auto& [symbol, states]: this->transitions) {
-            for (auto state: states) {
-                state->accept(visitor, visited_states);
-            }
+        for (const State* state: this->epsilon_transitions) {
+            state->accept(visitor, visited_states);
         }
-        for (const auto& [symbol, states]: this->transitions) {
-            for (auto state: states) {
-                visitor.visitTransition(this, symbol, state.get());
-            }
+        for (const Transition& transition: this->transitions) {
+            transition.target->accept(visitor, visited_states);
         }
-    }
-
-    bool State::matches(set<const State*>& visited_states, string_view input) const
-    {
-        if (visited_states.find(this) != visited_states.end()) {
-            return false;
+        for (const State* state: this->epsilon_transitions) {
+            visitor.visitTransition(this, EPSILON, state);
         }
-        visited_states.insert(this);
-
-        if (input.empty()) {
-            // no more input and we're at an accepting state. it matches!
-            if (this->accepting) {
-                return true;
-            }
-            // no more input but there may be epsilon transitions from this state that
-            // may lead to an accepting state. follow those epsilon transitions and try
-            // to match them.
-            if (auto next_states = this->get_transitions(EPSILON); next_states) {
-                for (auto next_state: *next_states) {
-                    // if we found an accepting state from epsilon transitions recursively,
-                    // then it's a match!
-                    if (next_state->matches(visited_states, "")) {
-                        return true;
-                    }
-                }
+        for (const Transition& transition: this->transitions) {
+            string symbol{ static_cast<char>(transition.from) };
+            if (transition.to != transition.from) {
+                symbol = "[" + symbol + "-" + static_cast<char>(transition.to) + "]";
             }
-            // no more input but we didn't found any accepting state. it's not a match!
-            return false;
+            visitor.visitTransition(this, symbol, transition.target);
         }
+    }
 
-        // there is input to be consumed.
-        // slice the input for symbols
-        char c = input.front();
-        string symbol{c};
-
-        string_view rest = input;
-        rest.remove_prefix(1);
-
-        // search for transitions using this symbol
-        if (auto next_states = this->get_transitions(symbol); next_states) {
-            // we should only share visited states between Epsilon transitions!
-            visited_states.clear();
-            for (auto next_state: *next_states) {
-                if (next_state->matches(visited_states, rest)) {
-                    return true;
-                }
-            }
-        }
-        // there still may be epsilon transitions for us to check
-        if (auto next_states = this->get_transitions(EPSILON); next_states) {
-            for (auto next_state: *next_states) {
-                if (next_state->matches(visited_states, input)) {
-                    return true;
-                }
-            }
-        }
+    vector<const State*> State::get_epsilon_closure() const
+    {
+        // reused across calls, so it stops allocating once it's as big as the graph
+        static thread_local SparseSet visited_states;
 
-        return false;
+        return this->get_epsilon_closure(visited_states);
     }
 
-    vector<const State*> State::get_epsilon_closure() const
+    vector<const State*> State::get_epsilon_closure(SparseSet& visited_states) const
     {
-        set<const State*> visited_states;
         vector<const State*> epsilon_states;
 
+        visited_states.clear();
         this->get_epsilon_states(visited_states, epsilon_states);
 
         return epsilon_states;
     }
 
-    void State::get_epsilon_states(set<const State*>& visited_states, vector<const State*>& epsilon_states) const
+    void State::get_epsilon_states(SparseSet& visited_states, vector<const State*>& epsilon_states) const
     {
-        if (visited_states.find(this) != visited_states.end()) {
+        if (!visited_states.insert(this->id)) {
             return;
         }
-        visited_states.insert(this);
         epsilon_states.push_back(this);
 
-        if (auto next_states = this->get_transitions(EPSILON); next_states) {
-            for (auto next_state: *next_states) {
-                next_state->get_epsilon_states(visited_states, epsilon_states);
-            }
+        for (const State* next_state: this->epsilon_transitions) {
+            next_state->get_epsilon_states(visited_states, epsilon_states);
         }
     }
 
+    uint32_t State::get_id() const
+    {
+        return this->id;
+    }
+
     bool State::is_accepting() const
     {
         return this->accepting;
     }
 
+    uint32_t State::get_incoming_count() const
+    {
+        return this->incoming_count;
+    }
+
     void State::set_accepting(bool accepting)
     {
         this->accepting = accepting;
     }
 
-    const std::map<std::string, States>& State::get_transitions() const
+    const States& State::get_epsilon_transitions() const
+    {
+        return this->epsilon_transitions;
+    }
+
+    const vector<Transition>& State::get_transitions() const
     {
         return this->transitions;
     }
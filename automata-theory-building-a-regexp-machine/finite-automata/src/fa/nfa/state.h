@@ -1,54 +1,104 @@
 #ifndef FA_STATE_H
 #define FA_STATE_H
 
-#include <map>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
 #include <string_view>
-#include <optional>
-#include <set>
-#include <tuple>
+
+#include <fa/sparse_set.h>
 
 namespace fa::nfa
 {
+    class Graph;
     class State;
     class Visitor;
 
-    using States = std::vector<std::shared_ptr<State>>;
+    using States = std::vector<State*>;
+
+    /**
+     * A transition reading any input byte in the (inclusive) interval [from, to].
+     *
+     * Single characters are just intervals with one byte.
+     */
+    struct Transition {
+        unsigned char from;
+        unsigned char to;
+        State* target;
+
+        [[nodiscard]]
+        bool contains(unsigned char c) const
+        {
+            return this->from <= c && c <= this->to;
+        }
+    };
 
     class State {
+        friend class Graph;
+
     protected:
+        // dense id in its graph (see Graph)
+        uint32_t id = 0;
+        // number of transitions (epsilon or not) targeting this state
+        uint32_t incoming_count = 0;
         bool accepting;
-        std::map<std::string, States> transitions;
+        States epsilon_transitions;
+        // sorted by interval start
+        std::vector<Transition> transitions;
 
-        void get_epsilon_states(std::set<const State*>& visited_states, std::vector<const State*>& epsilon_states) const;
+        void get_epsilon_states(fa::SparseSet& visited_states, std::vector<const State*>& epsilon_states) const;
 
     public:
         State(bool accepting = false) noexcept;
 
-        void add_transition(const std::string& symbol, std::shared_ptr<State> state);
+        /**
+         * Adds a transition for the given symbol: either EPSILON or a single character.
+         */
+        void add_transition(const std::string& symbol, State* state);
 
-        [[nodiscard]]
-        std::optional<States> get_transitions(const std::string& symbol) const;
+        void add_transition(char symbol, State* state);
+
+        /**
+         * Adds a transition reading any byte in the (inclusive) interval [from, to].
+         */
+        void add_range_transition(char from, char to, State* state);
 
+        void add_epsilon_transition(State* state);
+
+        /**
+         * Visits this state and all states reachable from it, skipping the ids in visited_states.
+         */
         void accept(
             Visitor& visitor,
-            std::set<const State*>& visited_states
+            fa::SparseSet& visited_states
         ) const;
 
-        bool matches(std::set<const State*>& visited_states, std::string_view input) const;
-
         [[nodiscard]]
         std::vector<const State*> get_epsilon_closure() const;
-        
+
+        /**
+         * Same as get_epsilon_closure(), using (and clearing) the given scratch set for the visited state ids.
+         */
+        [[nodiscard]]
+        std::vector<const State*> get_epsilon_closure(fa::SparseSet& visited_states) const;
+
         // GETTERS
 
+        [[nodiscard]]
+        uint32_t get_id() const;
+
         [[nodiscard]]
         bool is_accepting() const;
 
         [[nodiscard]]
-        const std::map<std::string, States>& get_transitions() const;
+        uint32_t get_incoming_count() const;
+
+        [[nodiscard]]
+        const States& get_epsilon_transitions() const;
+
+        [[nodiscard]]
+        const std::vector<Transition>& get_transitions() const;
 
         // SETTERS
         void set_accepting(bool accepting);
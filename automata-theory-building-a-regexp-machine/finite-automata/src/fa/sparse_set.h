@@ -0,0 +1,109 @@
+#ifndef FA_SPARSE_SET_H
+#define FA_SPARSE_SET_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fa
+{
+    /**
+     * Sparse Set (Briggs & Torczon).
+     *
+     * A set of small integers, like dense state ids, with O(1) insertion, lookup and clearing,
+     * iterated in insertion order. `dense` lists the values and `sparse` maps every value to its
+     * index in `dense`. A value is only in the set when both agree, so clearing just forgets the
+     * count and stale entries are never read. A single set can then be reused as scratch space
+     * for every step of a simulation without allocating or touching its whole memory.
+     *
+     * The set grows when a value beyond its capacity is inserted.
+     */
+    class SparseSet
+    {
+    protected:
+        std::vector<uint32_t> dense;
+        std::vector<uint32_t> sparse;
+        size_t count = 0;
+
+    public:
+        explicit SparseSet(size_t capacity = 0)
+            : dense(capacity)
+            , sparse(capacity)
+        {
+        }
+
+        [[nodiscard]]
+        bool contains(uint32_t value) const
+        {
+            return value < this->sparse.size()
+                && this->sparse[value] < this->count
+                && this->dense[this->sparse[value]] == value;
+        }
+
+        /**
+         * Inserts the given value, returning false if it was already in the set.
+         */
+        bool insert(uint32_t value)
+        {
+            if (this->contains(value)) {
+                return false;
+            }
+            if (value >= this->sparse.size()) {
+                this->reserve(std::max<size_t>(value + 1, 2 * this->sparse.size()));
+            }
+            this->dense[this->count] = value;
+            this->sparse[value] = static_cast<uint32_t>(this->count);
+            this->count++;
+            return true;
+        }
+
+        void clear()
+        {
+            this->count = 0;
+        }
+
+        /**
+         * Makes room for values up to capacity - 1.
+         */
+        void reserve(size_t capacity)
+        {
+            if (capacity > this->sparse.size()) {
+                this->dense.resize(capacity);
+                this->sparse.resize(capacity);
+            }
+        }
+
+        [[nodiscard]]
+        const uint32_t* begin() const
+        {
+            return this->dense.data();
+        }
+
+        [[nodiscard]]
+        const uint32_t* end() const
+        {
+            return this->dense.data() + this->count;
+        }
+
+        [[nodiscard]]
+        size_t size() const
+        {
+            return this->count;
+        }
+
+        [[nodiscard]]
+        bool empty() const
+        {
+            return this->count == 0;
+        }
+
+        [[nodiscard]]
+        size_t capacity() const
+        {
+            return this->sparse.size();
+        }
+    };
+}
+
+#endif
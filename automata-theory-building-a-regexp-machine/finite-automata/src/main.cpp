@@ -2,9 +2,31 @@
 #include <memory>
 #include <optional>
 #include <cassert>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+#include <unistd.h>
 
+#include "fa/sparse_set.h"
 #include "fa/nfa/state.h"
 #include "fa/nfa/nfa.h"
+#include "fa/nfa/automaton.h"
+#include "fa/nfa/simulator.h"
+#include "fa/nfa/shift_and.h"
+#include "fa/nfa/matcher.h"
+#include "fa/nfa/parser.h"
+#include "fa/nfa/literals.h"
+#include "fa/dfa/dfa.h"
+#include "fa/dfa/lazy.h"
+#include "fa/dfa/search.h"
+#include "fa/dfa/set.h"
+#include "fa/dfa/teddy.h"
+#include "fa/dfa/mapped.h"
+#include "fa/dfa/codegen.h"
+#include "fa/dfa/jit.h"
+#include "fa/glushkov/expr.h"
+#include "fa/ct/regex.h"
 
 using namespace std;
 using namespace fa::nfa;
@@ -265,13 +287,206 @@ static void test_optimizations_operator_char_range()
     visitor.dump_graph("/tmp/t13-optimization-range.dot");
 }
 
+static void test_char_class()
+{
+    cout << __func__ << ": ";
+    {
+        NFA regex = char_class({ {'a', 'z'}, {'0', '9'}, {'_', '_'}, {'b', 'f'} });
+        assert(regex.matches("a"));
+        assert(regex.matches("q"));
+        assert(regex.matches("5"));
+        assert(regex.matches("_"));
+        assert(!regex.matches("A"));
+        assert(!regex.matches("-"));
+        // [a-z] swallows [b-f]
+        assert(regex.in->get_transitions().size() == 3);
+    }
+    {
+        NFA regex = char_class({ {'\n', '\n'} }, true);
+        assert(regex.matches("a"));
+        assert(regex.matches("\xff"));
+        assert(regex.matches(string(1, '\0')));
+        assert(!regex.matches("\n"));
+        assert(regex.in->get_transitions().size() == 2);
+    }
+    {
+        // [\x00-\x7f]: a single transition, instead of 128
+        NFA regex = range('\x00', '\x7f');
+        assert(regex.in->get_transitions().size() == 1);
+        assert(regex.matches("\x7f"));
+        assert(!regex.matches("\x80"));
+
+        fa::dfa::Table dfa{ oneOrMore(regex) };
+        assert(dfa.matches("hello"));
+        assert(!dfa.matches("h\xc3\xa9llo"));
+        assert(dfa.get_state_count() == 3);
+    }
+
+    cout << "OK.\n";
+}
+
+static void test_compile()
+{
+    using fa::nfa::compile;
+    using fa::nfa::SyntaxError;
+
+    cout << __func__ << ": ";
+    {
+        NFA regex = compile("xy*|z");
+        assert(regex.matches("x"));
+        assert(regex.matches("xyyy"));
+        assert(regex.matches("z"));
+        assert(!regex.matches("zy"));
+        assert(!regex.matches(""));
+        // all states in a single graph, with no intermediate graphs merged into it
+        assert(Graph::root(regex.graph) == regex.graph);
+    }
+    {
+        NFA regex = compile("(ab|c)+d?");
+        assert(regex.matches("ab"));
+        assert(regex.matches("cabcd"));
+        assert(!regex.matches("d"));
+        assert(!regex.matches("abd d"));
+    }
+    {
+        NFA regex = compile("ERROR [0-9]+: [^\\n]*");
+        assert(regex.matches("ERROR 42: disk full"));
+        assert(!regex.matches("ERROR : disk full"));
+        assert(!regex.matches("ERROR 42: disk\nfull"));
+        assert((regex.find("[12:00] ERROR 7: oops") == fa::Match{ 8, 21 }));
+    }
+    {
+        assert(compile("\\d\\d-\\w+\\s\\S").matches("42-ab_9 x"));
+        assert(!compile("\\D").matches("5"));
+        assert(compile("[\\d_]+").matches("1_2"));
+        assert(compile("[^\\W]").matches("a"));
+        assert(!compile("[^\\W]").matches("-"));
+        assert(compile("a.c").matches("a-c"));
+        assert(!compile("a.c").matches("a\nc"));
+        assert(compile("\\(\\*\\)\\\\").matches("(*)\\"));
+        assert(compile("[]a-]+").matches("]-a"));
+        assert(compile("[a\\]]").matches("]"));
+        assert(compile("a|").matches(""));
+        assert(compile("()").matches(""));
+        assert(compile("").matches(""));
+        assert(!compile("").matches("a"));
+        assert(compile("\t\\t").matches("\t\t"));
+    }
+
+    auto error_at = [](string_view pattern) -> size_t {
+        try {
+            (void) compile(pattern);
+        } catch (const SyntaxError& error) {
+            return error.get_position();
+        }
+        return string_view::npos;
+    };
+    assert(error_at("a(b") == 3);
+    assert(error_at("ab)") == 2);
+    assert(error_at("*a") == 0);
+    assert(error_at("a|+") == 2);
+    assert(error_at("x[abc") == 1);
+    assert(error_at("[z-a]") == 4);
+    assert(error_at("a\\") == 2);
+    assert(error_at("\\q") == 1);
+    assert(error_at(string(fa::nfa::MAX_GROUP_DEPTH + 1, '(')) == fa::nfa::MAX_GROUP_DEPTH);
+    assert(error_at("{2}") == 0);
+    assert(error_at("a{x}") == 2);
+    assert(error_at("a{2") == 3);
+    assert(error_at("a{3,2}") == 1);
+
+    cout << "OK.\n";
+}
+
+static void test_repeat()
+{
+    using fa::nfa::compile;
+    using fa::nfa::repeat;
+
+    cout << __func__ << ": ";
+    {
+        // clones don't share states with the original
+        NFA a = concat(NFA{'a'}, zeroOrMore(NFA{'b'}));
+        NFA copy = fa::nfa::clone(a);
+        assert(copy.in != a.in && copy.out != a.out);
+        assert(Graph::root(copy.graph) == Graph::root(a.graph));
+        NFA both = a + copy;
+        assert(both.matches("abbab"));
+        assert(!both.matches("ab"));
+    }
+    {
+        NFA regex = repeat(NFA{'a'}, 2, 4);
+        assert(!regex.matches("a"));
+        assert(regex.matches("aa"));
+        assert(regex.matches("aaaa"));
+        assert(!regex.matches("aaaaa"));
+
+        assert(repeat(NFA{'a'}, 0, 2).matches(""));
+        assert(repeat(NFA{'a'}, 0, 0).matches(""));
+        assert(!repeat(NFA{'a'}, 0, 0).matches("a"));
+        assert(repeat(NFA{'a'}, 3).matches("aaaaaa"));
+        assert(!repeat(NFA{'a'}, 3).matches("aa"));
+        assert(repeat(NFA{'a'}, 0).matches(""));
+    }
+    {
+        // the optional tail keeps the number of states linear
+        NFA regex = repeat(range('0', '9'), 3, 100);
+        assert(fa::nfa::Automaton{ regex }.get_state_count() == 200);
+        assert(regex.matches("123"));
+        assert(regex.matches(string(100, '7')));
+        assert(!regex.matches(string(101, '7')));
+    }
+    {
+        NFA regex = compile("(ab|c){2,3}d{2}x{1,}");
+        assert(regex.matches("abcddx"));
+        assert(regex.matches("cccddxxx"));
+        assert(!regex.matches("cddx"));
+        assert(!regex.matches("ccccddx"));
+        assert(!regex.matches("ccdx"));
+        assert(compile("a{0,1}b").matches("b"));
+        assert(compile("(a*){2}").matches("aaa"));
+    }
+    {
+        // fails fast, without building a million states
+        bool thrown = false;
+        try {
+            (void) repeat(repeat(NFA{'x'}, 1000, 1000), 1000, 1000);
+        } catch (const length_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+
+        thrown = false;
+        try {
+            (void) compile("(x{1000}){1000}");
+        } catch (const fa::nfa::SyntaxError& error) {
+            assert(error.get_position() == 9);
+            thrown = true;
+        }
+        assert(thrown);
+
+        // a configurable limit
+        (void) compile("x{100}", 1000);
+        thrown = false;
+        try {
+            (void) compile("x{100}", 100);
+        } catch (const fa::nfa::SyntaxError&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+
+    cout << "OK.\n";
+}
+
 static void test_epsilon_closure()
 {
     cout << __func__ << ": ";
     {
-        auto s1 = make_shared<State>();
-        auto s2 = make_shared<State>();
-        auto s = make_shared<State>();
+        Graph graph;
+        auto s1 = graph.create_state();
+        auto s2 = graph.create_state();
+        auto s = graph.create_state();
 
         s->add_transition(EPSILON, s1);
         s->add_transition(EPSILON, s2);
@@ -279,20 +494,20 @@ static void test_epsilon_closure()
         const auto epsilon_closure = s->get_epsilon_closure();
 
         assert(epsilon_closure.size() == 3);
-        assert(epsilon_closure[0] == s.get());
-        assert(epsilon_closure[1] == s1.get());
-        assert(epsilon_closure[2] == s2.get());
+        assert(epsilon_closure[0] == s);
+        assert(epsilon_closure[1] == s1);
+        assert(epsilon_closure[2] == s2);
     }
     {
         NFA regex = NFA{'a'} | NFA{'b'};
 
         const auto epsilon_closure_in = regex.in->get_epsilon_closure();
         assert(epsilon_closure_in.size() == 3);
-        assert(epsilon_closure_in[0] == regex.in.get());
+        assert(epsilon_closure_in[0] == regex.in);
         
         const auto epsilon_closure_out = regex.out->get_epsilon_closure();
         assert(epsilon_closure_out.size() == 1);
-        assert(epsilon_closure_out[0] == regex.out.get());
+        assert(epsilon_closure_out[0] == regex.out);
     }
 
     cout << "OK.\n";
@@ -322,6 +537,929 @@ static void test_get_transitions_table()
     cout << "OK.\n";
 }
 
+static void test_sparse_set()
+{
+    cout << __func__ << ": ";
+
+    fa::SparseSet set{ 4 };
+    assert(set.empty());
+    assert(set.insert(3));
+    assert(set.insert(1));
+    assert(!set.insert(3));
+    assert(set.contains(1) && set.contains(3) && !set.contains(0) && !set.contains(100));
+    assert((vector<uint32_t>(set.begin(), set.end()) == vector<uint32_t>{ 3, 1 }));
+
+    set.clear();
+    assert(set.empty() && !set.contains(3));
+
+    // grows past its capacity
+    assert(set.insert(100));
+    assert(set.contains(100) && set.size() == 1 && set.capacity() > 100);
+
+    cout << "OK.\n";
+}
+
+static void test_graph()
+{
+    cout << __func__ << ": ";
+    {
+        Graph graph;
+        State* a = graph.create_state();
+        State* b = graph.create_state(true);
+        assert(graph.get_state_count() == 2);
+        assert(!a->is_accepting());
+        assert(b->is_accepting());
+        assert(a->get_id() == 0 && b->get_id() == 1);
+    }
+    {
+        NFA a{'a'};
+        NFA b{'b'};
+        NFA ab = a + b;
+
+        // all states end up owned by a single graph, and older fragments forward to it
+        assert(Graph::root(a.graph) == Graph::root(ab.graph));
+        assert(Graph::root(b.graph) == Graph::root(ab.graph));
+        assert(Graph::root(ab.graph)->get_state_count() == 4);
+
+        // merged states are renumbered, so ids stay dense
+        vector<bool> ids(4, false);
+        Graph::root(ab.graph)->for_each_state([&ids](const State* state) {
+            assert(state->get_id() < 4 && !ids[state->get_id()]);
+            ids[state->get_id()] = true;
+        });
+
+        // loops don't leak: the whole graph goes away with its last fragment
+        weak_ptr<Graph> graph = Graph::root(ab.graph);
+        {
+            NFA star = zeroOrMore(plus_naive(ab));
+            assert(star.matches("abab"));
+        }
+        a = NFA{};
+        b = NFA{};
+        ab = NFA{};
+        assert(graph.expired());
+    }
+
+    cout << "OK.\n";
+}
+
+static void test_automaton()
+{
+    cout << __func__ << ": ";
+    {
+        Automaton automaton{ NFA{'a'} | range('0', '2') };
+        assert(automaton.get_state_count() == 6);
+
+        uint32_t starting = automaton.get_starting_state();
+        assert(!automaton.is_accepting(starting));
+        assert(automaton.get_transitions(starting).empty());
+        assert(automaton.get_epsilon_transitions(starting).size() == 2);
+
+        size_t accepting_count = 0;
+        size_t edge_count = 0;
+        for (uint32_t state = 0; state < automaton.get_state_count(); state++) {
+            accepting_count += automaton.is_accepting(state);
+            unsigned char previous = 0;
+            for (const auto& edge: automaton.get_transitions(state)) {
+                // transitions are sorted by interval start
+                assert(edge.from >= previous);
+                previous = edge.from;
+                edge_count++;
+            }
+        }
+        assert(accepting_count == 1);
+        // 'a' and the single [0-2] interval
+        assert(edge_count == 2);
+    }
+    {
+        // states not reachable from the input state are left out
+        NFA a{'a'};
+        NFA b{'b'};
+        NFA ab = a + b;
+        Automaton automaton{ b };
+        assert(automaton.get_state_count() == 2);
+    }
+    {
+        // a*b|c: 10 states with epsilon transitions
+        NFA regex = disjoint(concat(zeroOrMore(NFA{'a'}), NFA{'b'}), NFA{'c'});
+        Automaton automaton{ regex };
+        Automaton epsilon_free = automaton.without_epsilons();
+        assert(epsilon_free.get_state_count() < automaton.get_state_count());
+
+        size_t accepting_count = 0;
+        for (uint32_t state = 0; state < epsilon_free.get_state_count(); state++) {
+            assert(epsilon_free.get_epsilon_transitions(state).empty());
+            accepting_count += epsilon_free.is_accepting(state);
+        }
+        // the outputs of b and c, the a loop isn't accepting
+        assert(accepting_count == 2);
+        assert(epsilon_free.get_transitions(epsilon_free.get_starting_state()).size() == 3);
+
+        // both recognize the same language
+        Simulator simulator{ automaton };
+        Simulator epsilon_free_simulator{ epsilon_free };
+        for (string input: { "", "b", "c", "ab", "aaab", "aac", "bc", "a" }) {
+            assert(simulator.matches(input) == epsilon_free_simulator.matches(input));
+            assert(simulator.find(input) == epsilon_free_simulator.find(input));
+        }
+
+        // accepting through an epsilon closure
+        Automaton star = Automaton{ zeroOrMore(NFA{'a'}) }.without_epsilons();
+        assert(star.is_accepting(star.get_starting_state()));
+    }
+
+    cout << "OK.\n";
+}
+
+static void test_simulator()
+{
+    cout << __func__ << ": ";
+    {
+        // (a*)*b would make a backtracking matcher explode on a long run of a's without the b
+        Simulator simulator{ concat(kleene_naive(kleene_naive(NFA{'a'})), NFA{'b'}) };
+        const string as(100000, 'a');
+        assert(simulator.matches("b"));
+        assert(simulator.matches("aab"));
+        assert(simulator.matches(as + "b"));
+        assert(!simulator.matches(as));
+        assert(!simulator.matches(as + "c"));
+    }
+    {
+        Simulator simulator{ oneOrMore(disjoint(NFA{'a'}, concat(NFA{'b'}, NFA{'c'}))) };
+        assert(simulator.matches("a"));
+        assert(simulator.matches("bcabca"));
+        assert(!simulator.matches(""));
+        assert(!simulator.matches("ab"));
+    }
+
+    cout << "OK.\n";
+}
+
+/**
+ * (a|b)*a(a|b){n}: the full DFA for this needs 2^(n+1) states.
+ */
+static NFA nth_from_last_a(size_t n)
+{
+    NFA regex = concat(
+        zeroOrMore(disjoint(NFA{'a'}, NFA{'b'})),
+        NFA{'a'}
+    );
+    for (size_t i = 0; i < n; i++) {
+        regex = regex + disjoint(NFA{'a'}, NFA{'b'});
+    }
+    return regex;
+}
+
+static void test_shift_and()
+{
+    using fa::nfa::Automaton;
+    using fa::nfa::ShiftAnd;
+
+    cout << __func__ << ": ";
+
+    vector<NFA> regexes = {
+        concat(kleene_naive(kleene_naive(NFA{'a'})), NFA{'b'}),
+        oneOrMore(disjoint(NFA{'a'}, concat(NFA{'b'}, NFA{'c'}))),
+        concat(NFA{'a'}, opt(NFA{'b'}), zeroOrMore(char_class({ {'c', 'd'} })), NFA{'a'}),
+        char_class({ {'a', 'b'}, {'d', 'd'} }, true),
+        nth_from_last_a(5),
+        NFA{},
+    };
+    srand(3);
+    for (const NFA& regex: regexes) {
+        Automaton automaton{ regex };
+        assert(ShiftAnd::fits(automaton));
+        ShiftAnd shift_and{ automaton };
+        Simulator simulator{ regex };
+        for (size_t i = 0; i < 300; i++) {
+            string input;
+            for (size_t j = rand() % 12; j > 0; j--) {
+                input.push_back(static_cast<char>('a' + rand() % 5));
+            }
+            assert(shift_and.matches(input) == simulator.matches(input));
+            assert(regex.matches(input) == simulator.matches(input));
+        }
+    }
+
+    // too many states
+    assert(!ShiftAnd::fits(Automaton{ nth_from_last_a(20) }));
+    assert(nth_from_last_a(20).matches("ba" + string(20, 'b')));
+    // reversed byte transitions go backwards
+    assert(!ShiftAnd::fits(Automaton{ fa::nfa::reverse(concat(NFA{'a'}, NFA{'b'})) }));
+
+    // the Matcher picks ShiftAnd once, when it fits
+    Matcher small{ nth_from_last_a(3) };
+    assert(small.is_shift_and());
+    assert(small.matches("baabb") && !small.matches("bbabb"));
+    Matcher large{ nth_from_last_a(20) };
+    assert(!large.is_shift_and());
+    assert(large.matches("ba" + string(20, 'b')) && !large.matches(string(22, 'b')));
+
+    cout << "OK.\n";
+}
+
+static void test_find()
+{
+    cout << __func__ << ": ";
+    {
+        // ERROR[0-9]+
+        NFA regex = concat(NFA{'E'}, NFA{'R'}, NFA{'R'}, NFA{'O'}, NFA{'R'}, oneOrMore(range('0', '9')));
+        assert(regex.find("") == nullopt);
+        assert(regex.find("all good") == nullopt);
+        assert((regex.find("ERROR42") == fa::Match{ 0, 7 }));
+        assert((regex.find("[ERROR] ERROR ERROR123: ERROR7") == fa::Match{ 14, 22 }));
+        assert(regex.match("oops ERROR1 happened"));
+        assert(!regex.match("oops ERROR happened"));
+    }
+    {
+        // leftmost wins over longest: x(y*) finds "xyy" in "axyyxyyy"
+        NFA regex = concat(NFA{'x'}, zeroOrMore(NFA{'y'}));
+        assert((regex.find("axyyxyyy") == fa::Match{ 1, 4 }));
+
+        vector<fa::Match> matches;
+        for (fa::Match match: regex.find_all("axyyxyyyx")) {
+            matches.push_back(match);
+        }
+        assert((matches == vector<fa::Match>{ {1, 4}, {4, 8}, {8, 9} }));
+    }
+    {
+        // longest among the leftmost: a|ab|abc
+        NFA regex = disjoint(NFA{'a'}, concat(NFA{'a'}, NFA{'b'}), concat(NFA{'a'}, NFA{'b'}, NFA{'c'}));
+        assert((regex.find("zzabcd") == fa::Match{ 2, 5 }));
+        assert((regex.find("zzabd") == fa::Match{ 2, 4 }));
+    }
+    {
+        // empty matches: a* on "aab" finds "aa", then empty matches at 2 and 3
+        NFA regex = zeroOrMore(NFA{'a'});
+        vector<fa::Match> matches;
+        for (fa::Match match: regex.find_all("aab")) {
+            matches.push_back(match);
+        }
+        assert((matches == vector<fa::Match>{ {0, 2}, {2, 2}, {3, 3} }));
+    }
+
+    cout << "OK.\n";
+}
+
+static void test_dfa_table()
+{
+    cout << __func__ << ": ";
+    {
+        fa::dfa::Table dfa{ NFA{'a'} | NFA{'b'} };
+        assert(dfa.matches("a"));
+        assert(dfa.matches("b"));
+        assert(!dfa.matches(""));
+        assert(!dfa.matches("ab"));
+        assert(!dfa.matches("c"));
+    }
+    {
+        // xy*|z
+        fa::dfa::Table dfa{
+            disjoint(
+                concat(
+                    NFA{'x'},
+                    kleene_naive(NFA{'y'})
+                ),
+                NFA{'z'}
+            )
+        };
+        assert(dfa.matches("z"));
+        assert(dfa.matches("x"));
+        assert(dfa.matches("xy"));
+        assert(dfa.matches("xyyy"));
+        assert(!dfa.matches(""));
+        assert(!dfa.matches("y"));
+        assert(!dfa.matches("xz"));
+        assert(dfa.get_state_count() > 1);
+    }
+    {
+        fa::dfa::Table dfa{ concat(NFA{'a'}, zeroOrMore(range('0', '9')), opt(NFA{'b'})) };
+        assert(dfa.matches("a"));
+        assert(dfa.matches("a0123"));
+        assert(dfa.matches("a99b"));
+        assert(dfa.matches("ab"));
+        assert(!dfa.matches("a9bb"));
+        assert(!dfa.matches("b"));
+    }
+
+    cout << "OK.\n";
+}
+
+static void test_dfa_minimization()
+{
+    cout << __func__ << ":\n";
+
+    auto check = [](const char* title, NFA nfa, size_t expected_state_count) {
+        fa::dfa::Table dfa{ nfa };
+        cout << "  " << title << ": " << dfa.get_unminimized_state_count();
+        cout << " -> " << dfa.get_state_count() << " states\n";
+        assert(dfa.get_state_count() <= dfa.get_unminimized_state_count());
+        assert(dfa.get_state_count() == expected_state_count);
+        return dfa;
+    };
+
+    // dead state + a single looping accepting state
+    auto kleene = check("kleene_naive: a*", kleene_naive(NFA{'a'}), 2);
+    assert(kleene.matches(""));
+    assert(kleene.matches("aaa"));
+    assert(!kleene.matches("ab"));
+
+    // dead state + starting state + a looping accepting state
+    auto plus = check("plus_naive: a+", plus_naive(NFA{'a'}), 3);
+    assert(!plus.matches(""));
+    assert(plus.matches("aaa"));
+
+    // dead state + starting state + accepting state
+    auto digits = check("char_range_naive: [0-9]", char_range_naive('0', '9'), 3);
+    assert(digits.matches("7"));
+    assert(!digits.matches("77"));
+
+    cout << "OK.\n";
+}
+
+static void test_byte_classes()
+{
+    cout << __func__ << ": ";
+    {
+        // [0-9]+(a|b): {\0-/}, {0-9}, {:-`}, {a}, {b}, {c-\xff}
+        auto regex = concat(oneOrMore(range('0', '9')), disjoint(NFA{'a'}, NFA{'b'}));
+        fa::dfa::ByteClasses classes{ Automaton{ regex } };
+        assert(classes.get_class_count() == 6);
+        assert(classes.get('0') == classes.get('9'));
+        assert(classes.get('0') != classes.get('/'));
+        assert(classes.get('a') != classes.get('b'));
+        assert(classes.get('c') == classes.get('\xff'));
+        assert(classes.get('\0') == classes.get('/'));
+        for (size_t c = 0; c < classes.get_class_count(); c++) {
+            assert(classes.get(classes.get_representative(c)) == c);
+        }
+
+        fa::dfa::Table dfa{ regex };
+        assert(dfa.get_byte_classes().get_class_count() == 6);
+        assert(dfa.matches("0123a"));
+        assert(dfa.matches("9b"));
+        assert(!dfa.matches("a"));
+        assert(!dfa.matches("12c"));
+    }
+    {
+        fa::dfa::ByteClasses classes;
+        assert(classes.get_class_count() == 1);
+        assert(classes.get('x') == 0);
+    }
+
+    cout << "OK.\n";
+}
+
+static void test_reverse()
+{
+    cout << __func__ << ": ";
+
+    // xy*|z reversed is y*x|z
+    NFA regex = reverse(disjoint(concat(NFA{'x'}, zeroOrMore(NFA{'y'})), NFA{'z'}));
+    assert(regex.matches("x"));
+    assert(regex.matches("yyx"));
+    assert(regex.matches("z"));
+    assert(!regex.matches("xy"));
+    assert(!regex.matches("zx"));
+
+    cout << "OK.\n";
+}
+
+template <typename Engine>
+static vector<fa::Match> find_all(Engine engine, string_view input)
+{
+    vector<fa::Match> matches;
+    for (fa::Match match: fa::Matches<Engine>{ move(engine), input }) {
+        matches.push_back(match);
+    }
+    return matches;
+}
+
+static void test_required_literals()
+{
+    using fa::nfa::required_literals;
+
+    cout << __func__ << ": ";
+    {
+        // ERROR[0-9]+
+        auto literals = required_literals(fa::nfa::Automaton{ concat(
+            NFA{'E'}, NFA{'R'}, NFA{'R'}, NFA{'O'}, NFA{'R'}, oneOrMore(range('0', '9'))
+        ) });
+        assert(literals.prefix == "ERROR");
+        assert(literals.inner == "ERROR");
+    }
+    {
+        // [0-9]+ERROR
+        auto literals = required_literals(fa::nfa::Automaton{ concat(
+            oneOrMore(range('0', '9')), NFA{'E'}, NFA{'R'}, NFA{'R'}, NFA{'O'}, NFA{'R'}
+        ) });
+        assert(literals.prefix.empty());
+        assert(literals.inner == "ERROR");
+    }
+    {
+        // the x of xy*|z is not required by the other branch
+        auto literals = required_literals(fa::nfa::Automaton{ disjoint(
+            concat(NFA{'x'}, zeroOrMore(NFA{'y'})), NFA{'z'}
+        ) });
+        assert(literals.prefix.empty());
+        assert(literals.inner.empty());
+    }
+    {
+        // a common prefix of both branches
+        auto literals = required_literals(fa::nfa::Automaton{ disjoint(
+            concat(NFA{'a'}, NFA{'b'}), concat(NFA{'a'}, NFA{'c'})
+        ) });
+        assert(literals.prefix == "a");
+    }
+    {
+        // optional parts are not required
+        auto literals = required_literals(fa::nfa::Automaton{ concat(opt(NFA{'a'}), NFA{'b'}, zeroOrMore(NFA{'c'})) });
+        assert(literals.prefix.empty());
+        assert(literals.inner == "b");
+    }
+    {
+        fa::dfa::Searcher searcher{ concat(NFA{'a'}, NFA{'b'}, zeroOrMore(range('0', '9'))) };
+        assert(searcher.get_literals().prefix == "ab");
+        assert((find_all(searcher, "xxab12yab3aab") == vector<fa::Match>{ {2, 6}, {7, 10}, {11, 13} }));
+    }
+
+    cout << "OK.\n";
+}
+
+static void test_dfa_search()
+{
+    cout << __func__ << ": ";
+    {
+        fa::dfa::Searcher searcher{ concat(NFA{'x'}, zeroOrMore(NFA{'y'})) };
+        assert((searcher.find("axyyxyyy") == fa::Match{ 1, 4 }));
+        assert((searcher.find("axyyxyyy", 2) == fa::Match{ 4, 8 }));
+        assert(searcher.find("abc") == nullopt);
+        assert((find_all(searcher, "axyyxyyyx") == vector<fa::Match>{ {1, 4}, {4, 8}, {8, 9} }));
+        assert((searcher.find_next("axyyxyyyx", 5) == fa::Match{ 8, 9 }));
+    }
+    {
+        // the forward run from the prefix at 0 reads past the match starting at 2
+        fa::dfa::Searcher searcher{ disjoint(concat(NFA{'a'}, NFA{'b'}, NFA{'a'}, NFA{'b'}, NFA{'c'}), concat(NFA{'a'}, NFA{'b'}, NFA{'d'})) };
+        assert(searcher.get_literals().prefix == "ab");
+        assert((searcher.find("ababd") == fa::Match{ 2, 5 }));
+        assert((find_all(searcher, "ababdababc") == vector<fa::Match>{ {2, 5}, {5, 10} }));
+    }
+    {
+        // ab[^c]*c over abab... never matches, and must not run the forward DFA from every ab
+        fa::dfa::Searcher searcher{ concat(NFA{'a'}, NFA{'b'}, zeroOrMore(char_class({ {'c', 'c'} }, true)), NFA{'c'}) };
+        assert(searcher.get_literals().prefix == "ab");
+        string input;
+        for (size_t i = 0; i < 100000; i++) {
+            input += "ab";
+        }
+        assert(searcher.find(input) == nullopt);
+        input.back() = 'c';
+        assert((searcher.find(input) == fa::Match{ 0, input.size() }));
+    }
+    {
+        // the same buffer, rewritten with the same size between two searches
+        fa::dfa::Searcher searcher{ concat(NFA{'x'}, zeroOrMore(NFA{'y'})) };
+        string input = "xyaaxy";
+        assert((searcher.find(input, 1) == fa::Match{ 4, 6 }));
+        input = "aaxyaa";
+        assert((searcher.find(input, 1) == fa::Match{ 2, 4 }));
+    }
+    {
+        // the leftmost match is not the one ending first
+        fa::dfa::Searcher searcher{ disjoint(concat(NFA{'a'}, NFA{'b'}, NFA{'c'}, NFA{'d'}), NFA{'c'}) };
+        assert((searcher.find("abcd") == fa::Match{ 0, 4 }));
+        assert((searcher.find("abce") == fa::Match{ 2, 3 }));
+    }
+    {
+        // the DFA searcher must agree with the NFA simulator
+        vector<NFA> regexes = {
+            concat(oneOrMore(range('a', 'b')), NFA{'c'}),
+            zeroOrMore(NFA{'a'}),
+            disjoint(NFA{'a'}, concat(NFA{'a'}, NFA{'b'}), concat(NFA{'b'}, NFA{'c'}, NFA{'a'})),
+            concat(NFA{'a'}, opt(NFA{'b'}), zeroOrMore(char_class({ {'c', 'd'} })), NFA{'a'}),
+            concat(NFA{'a'}, NFA{'b'}, zeroOrMore(NFA{'c'})),
+            concat(zeroOrMore(range('a', 'b')), NFA{'c'}, NFA{'d'}),
+        };
+        srand(7);
+        for (const NFA& regex: regexes) {
+            fa::dfa::Searcher searcher{ regex };
+            for (size_t i = 0; i < 200; i++) {
+                string input;
+                for (size_t j = rand() % 16; j > 0; j--) {
+                    input.push_back(static_cast<char>('a' + rand() % 4));
+                }
+                assert(find_all(searcher, input) == find_all(Simulator{ regex }, input));
+            }
+        }
+    }
+
+    cout << "OK.\n";
+}
+
+static void test_regex_set()
+{
+    cout << __func__ << ": ";
+
+    NFA digits = oneOrMore(range('0', '9'));
+    fa::dfa::RegexSet set{ {
+        concat(NFA{'E'}, NFA{'R'}, NFA{'R'}, digits),   // 0: ERR[0-9]+
+        concat(NFA{'W'}, NFA{'A'}, NFA{'R'}, NFA{'N'}), // 1: WARN
+        digits,                                         // 2: [0-9]+
+        concat(NFA{'E'}, NFA{'R'}, NFA{'R'}),           // 3: ERR
+        zeroOrMore(NFA{'x'}),                           // 4: x*
+    } };
+    assert(set.get_pattern_count() == 5);
+
+    assert((set.matches("ERR42") == vector<size_t>{ 0 }));
+    assert((set.matches("42") == vector<size_t>{ 2 }));
+    assert((set.matches("ERR") == vector<size_t>{ 3 }));
+    assert((set.matches("") == vector<size_t>{ 4 }));
+    assert(set.matches("ERR42 WARN").empty());
+
+    assert((set.search("ERR42 WARN") == vector<size_t>{ 0, 1, 2, 3, 4 }));
+    assert((set.search("all good, WARN") == vector<size_t>{ 1, 4 }));
+    assert((set.search("ERR") == vector<size_t>{ 3, 4 }));
+
+    // more than 64 patterns
+    vector<NFA> many;
+    for (char c = '!'; c <= '~'; c++) {
+        many.push_back(concat(NFA{c}, NFA{c}));
+    }
+    fa::dfa::RegexSet many_set{ many };
+    assert((many_set.search("zz and ~~ and !!") == vector<size_t>{ 0, 'z' - '!', '~' - '!' }));
+    assert((many_set.matches("~~") == vector<size_t>{ '~' - '!' }));
+
+    cout << "OK.\n";
+}
+
+static void test_teddy()
+{
+    using fa::dfa::Teddy;
+
+    cout << __func__ << ": ";
+
+    vector<string> literals = { "ERR", "WARN", "abc", "ab", "zz", "\xff\x01", "~~~~" };
+    auto brute_force = [&](string_view input, size_t from) {
+        for (size_t position = from; position < input.size(); position++) {
+            for (const string& literal: literals) {
+                if (input.compare(position, literal.size(), literal) == 0) {
+                    return position;
+                }
+            }
+        }
+        return string_view::npos;
+    };
+
+    srand(13);
+    for (Teddy::Isa isa: { Teddy::Isa::SCALAR, Teddy::Isa::SSSE3, Teddy::Isa::AVX2 }) {
+        Teddy teddy{ literals, isa };
+        assert(teddy.get_mask_length() == 2);
+        assert(teddy.find("no literal here") == string_view::npos);
+        assert(teddy.find("a WARNING") == 2);
+        assert(teddy.find("the ERR in ERRORS", 5) == 11);
+
+        string alphabet = "ERWANabcz~\xff\x01 ";
+        for (size_t i = 0; i < 300; i++) {
+            string input;
+            for (size_t j = rand() % 100; j > 0; j--) {
+                input.push_back(alphabet[rand() % alphabet.size()]);
+            }
+            size_t from = input.empty() ? 0 : rand() % input.size();
+            assert(teddy.find(input, from) == brute_force(input, from));
+        }
+    }
+
+    // RegexSet searches skip to the literals every pattern starts with
+    NFA digits = oneOrMore(range('0', '9'));
+    vector<NFA> rules = {
+        concat(NFA{'E'}, NFA{'R'}, NFA{'R'}, digits),
+        concat(NFA{'W'}, NFA{'A'}, NFA{'R'}, NFA{'N'}, zeroOrMore(range('a', 'z'))),
+        concat(NFA{'a'}, NFA{'b'}, disjoint(NFA{'c'}, NFA{'R'})),
+    };
+    fa::dfa::RegexSet set{ rules };
+    assert(set.get_prefilter().has_value());
+    string alphabet = "ERWNAabc01 ";
+    for (size_t i = 0; i < 300; i++) {
+        string input;
+        for (size_t j = rand() % 80; j > 0; j--) {
+            input.push_back(alphabet[rand() % alphabet.size()]);
+        }
+        vector<size_t> expected;
+        for (size_t rule = 0; rule < rules.size(); rule++) {
+            if (Simulator{ rules[rule] }.find(input)) {
+                expected.push_back(rule);
+            }
+        }
+        assert(set.search(input) == expected);
+    }
+
+    cout << "OK.\n";
+}
+
+static void test_lazy_dfa()
+{
+    cout << __func__ << ": ";
+    {
+        fa::dfa::LazyDFA dfa{ disjoint(concat(NFA{'x'}, kleene_naive(NFA{'y'})), NFA{'z'}) };
+        assert(dfa.matches("z"));
+        assert(dfa.matches("xyyy"));
+        assert(!dfa.matches("xz"));
+        assert(!dfa.matches(""));
+        assert(dfa.get_flush_count() == 0);
+    }
+    {
+        const size_t n = 20;
+        Simulator simulator{ nth_from_last_a(n) };
+        fa::dfa::LazyDFA roomy{ nth_from_last_a(n), 64 << 20 };
+        fa::dfa::LazyDFA tiny{ nth_from_last_a(n), 2 * 1024 };
+
+        srand(42);
+        for (size_t i = 0; i < 200; i++) {
+            string input;
+            for (size_t j = 0; j < 64; j++) {
+                input.push_back(rand() % 2 ? 'a' : 'b');
+            }
+            const bool expected = simulator.matches(input);
+            assert(roomy.matches(input) == expected);
+            assert(tiny.matches(input) == expected);
+        }
+        assert(tiny.get_memory_used() <= 2 * 1024);
+        assert(tiny.get_flush_count() > 0);
+        assert(tiny.get_fallback_count() > 0);
+        assert(roomy.get_flush_count() == 0);
+    }
+
+    cout << "OK.\n";
+}
+
+static void test_table_serialization()
+{
+    using fa::dfa::FormatError;
+    using fa::dfa::MappedTable;
+    using fa::dfa::Table;
+    using fa::dfa::TableView;
+
+    cout << __func__ << ": ";
+
+    Table table{ fa::nfa::compile("(ERR|WARN)[0-9]{2,4}|x*y") };
+    string data = table.serialize();
+    // the view needs 8 bytes aligned data
+    vector<uint64_t> buffer((data.size() + 7) / 8);
+    memcpy(buffer.data(), data.data(), data.size());
+
+    TableView view{ buffer.data(), data.size() };
+    assert(view.get_state_count() == table.get_state_count());
+    assert(view.get_starting_state() == table.get_starting_state());
+    srand(23);
+    const string alphabet = "ERWAN0129xy";
+    for (size_t i = 0; i < 300; i++) {
+        string input;
+        for (size_t j = rand() % 10; j > 0; j--) {
+            input.push_back(alphabet[rand() % alphabet.size()]);
+        }
+        assert(view.matches(input) == table.matches(input));
+        assert(view.longest_match(input) == table.longest_match(input));
+    }
+    assert(view.matches("WARN123"));
+
+    auto invalid = [&buffer](size_t size) {
+        try {
+            TableView{ buffer.data(), size };
+        } catch (const FormatError&) {
+            return true;
+        }
+        return false;
+    };
+    assert(invalid(data.size() - 1));
+    assert(invalid(16));
+    auto* bytes = reinterpret_cast<unsigned char*>(buffer.data());
+    bytes[data.size() - 1] ^= 1;
+    assert(invalid(data.size()));
+    bytes[data.size() - 1] ^= 1;
+    bytes[0] = 'X';
+    assert(invalid(data.size()));
+    bytes[0] = 'F';
+    assert(!invalid(data.size()));
+
+    // pattern sets keep their accepted patterns
+    {
+        Table set_table{ fa::nfa::Automaton{ vector<NFA>{ fa::nfa::compile("a+"), fa::nfa::compile("a|b") } } };
+        string set_data = set_table.serialize();
+        vector<uint64_t> set_buffer((set_data.size() + 7) / 8);
+        memcpy(set_buffer.data(), set_data.data(), set_data.size());
+        TableView set_view{ set_buffer.data(), set_data.size() };
+        assert(set_view.get_pattern_count() == 2);
+        uint32_t state = set_view.next(set_view.get_starting_state(), 'a');
+        assert(set_view.accepts_pattern(state, 0) && set_view.accepts_pattern(state, 1));
+        state = set_view.next(state, 'a');
+        assert(set_view.accepts_pattern(state, 0) && !set_view.accepts_pattern(state, 1));
+    }
+
+    // memory mapped from a file
+    string path = "/tmp/fa-test-" + to_string(getpid()) + ".dfa";
+    {
+        ofstream file{ path, ios::binary };
+        table.save(file);
+    }
+    {
+        MappedTable mapped{ path };
+        assert(mapped.matches("ERR42"));
+        assert(!mapped.matches("ERR4"));
+        assert(mapped.longest_match("xxyz") == 3);
+
+        MappedTable moved = move(mapped);
+        assert(moved.matches("xy"));
+    }
+    remove(path.c_str());
+
+    bool thrown = false;
+    try {
+        MappedTable missing{ path };
+    } catch (const system_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    cout << "OK.\n";
+}
+
+/**
+ * The generated code itself is compiled and checked by the generated-matchers-check target.
+ */
+static void test_codegen()
+{
+    using fa::dfa::CodeStyle;
+    using fa::dfa::generate_matcher;
+
+    cout << __func__ << ": ";
+
+    fa::dfa::Table table{ fa::nfa::compile("a[0-9]+(.|\n)*") };
+    {
+        ostringstream os;
+        generate_matcher(os, table, "matcher");
+        string code = os.str();
+        assert(code.find("inline bool matcher(std::string_view input) noexcept") != string::npos);
+        assert(code.find("goto s") != string::npos);
+        assert(code.find("if (c >= 0x30 && c <= 0x39)") != string::npos);
+    }
+    {
+        ostringstream os;
+        generate_matcher(os, table, "matcher", CodeStyle::TABLE);
+        string code = os.str();
+        assert(code.find("static constexpr std::uint8_t transitions[" + to_string(table.get_state_count())) != string::npos);
+        assert(code.find("goto") == string::npos);
+    }
+
+    assert(fa::dfa::string_literal("a\"b\\c\n1") == "\"a\\\"b\\\\c\\0121\"");
+
+    cout << "OK.\n";
+}
+
+static void test_jit()
+{
+    cout << __func__ << ": ";
+
+    vector<string> patterns = {
+        "xy*|z",
+        "(a|b)*a(a|b)(a|b)",
+        "",
+        "[0-9]{1,3}(\\.[0-9]{1,3}){3}",
+        // states with many byte ranges dispatch through jump tables
+        "([a-c]|[e-g]|[i-k]|[m-o]|[q-s]|[u-w]|y)+[^x]",
+    };
+    const string alphabet = "abcdefghxyz0123456789.";
+
+    srand(23);
+    for (const string& pattern: patterns) {
+        fa::dfa::Jit jit{ fa::dfa::Table{ fa::nfa::compile(pattern) } };
+        assert(jit.is_compiled() == fa::dfa::Jit::is_supported());
+        assert(jit.is_compiled() == (jit.get_code_size() > 0));
+        const fa::dfa::Table& table = jit.get_table();
+        for (size_t i = 0; i < 500; i++) {
+            string input;
+            for (size_t j = rand() % 16; j > 0; j--) {
+                input.push_back(alphabet[rand() % alphabet.size()]);
+            }
+            assert(jit.matches(input) == table.matches(input));
+            assert(jit.longest_match(input) == table.longest_match(input));
+        }
+    }
+
+    fa::dfa::Jit ip{ fa::dfa::Table{ fa::nfa::compile("[0-9]{1,3}(\\.[0-9]{1,3}){3}") } };
+    assert(ip.matches("192.168.0.1"));
+    assert(!ip.matches("192.168.0.1."));
+    assert(ip.longest_match("10.0.0.255x") == 10u);
+    assert(!ip.longest_match("x10.0.0.1"));
+    assert(!ip.matches(string_view{}));
+
+    // moved code pages stay usable
+    fa::dfa::Jit moved = move(ip);
+    assert(moved.matches("1.2.3.4"));
+    ip = move(moved);
+    assert(ip.matches("1.2.3.4"));
+
+    cout << "OK.\n";
+}
+
+static void test_glushkov()
+{
+    namespace g = fa::glushkov;
+
+    cout << __func__ << ": ";
+
+    // the same expressions, built with both constructions
+    vector<pair<g::Expr, NFA>> regexes = {
+        { g::Expr{'a'}, NFA{'a'} },
+        { g::Expr{}, NFA{} },
+        { g::concat(g::Expr{'a'}, g::Expr{'b'}, g::Expr{'c'}), concat(NFA{'a'}, NFA{'b'}, NFA{'c'}) },
+        { g::disjoint(g::Expr{'a'}, g::concat(g::Expr{'b'}, g::Expr{'c'})), disjoint(NFA{'a'}, concat(NFA{'b'}, NFA{'c'})) },
+        {
+            g::concat(g::zeroOrMore(g::disjoint(g::Expr{'a'}, g::Expr{'b'})), g::Expr{'a'}, g::disjoint(g::Expr{'a'}, g::Expr{'b'})),
+            concat(zeroOrMore(disjoint(NFA{'a'}, NFA{'b'})), NFA{'a'}, disjoint(NFA{'a'}, NFA{'b'})),
+        },
+        {
+            g::concat(g::oneOrMore(g::range('a', 'c')), g::opt(g::Expr{'d'}), g::zeroOrMore(g::zeroOrMore(g::Expr{'e'}))),
+            concat(oneOrMore(range('a', 'c')), opt(NFA{'d'}), zeroOrMore(zeroOrMore(NFA{'e'}))),
+        },
+        {
+            g::oneOrMore(g::disjoint(g::opt(g::Expr{'a'}), g::concat(g::Expr{'b'}, g::Expr{'c'}))),
+            oneOrMore(disjoint(opt(NFA{'a'}), concat(NFA{'b'}, NFA{'c'}))),
+        },
+    };
+
+    srand(17);
+    for (const auto& [expr, nfa]: regexes) {
+        Automaton automaton = g::compile(expr);
+        // one state per position plus the starting state, and no epsilon transitions
+        assert(automaton.get_state_count() == expr.get_position_count() + 1);
+        for (uint32_t state = 0; state < automaton.get_state_count(); state++) {
+            assert(automaton.get_epsilon_transitions(state).empty());
+        }
+
+        Simulator glushkov{ automaton };
+        Simulator thompson{ nfa };
+        fa::dfa::Table dfa{ automaton };
+        for (size_t i = 0; i < 200; i++) {
+            string input;
+            for (size_t j = rand() % 8; j > 0; j--) {
+                input.push_back(static_cast<char>('a' + rand() % 5));
+            }
+            assert(glushkov.matches(input) == thompson.matches(input));
+            assert(dfa.matches(input) == thompson.matches(input));
+            assert(glushkov.find(input) == thompson.find(input));
+        }
+    }
+
+    cout << "OK.\n";
+}
+
+static constexpr char ct_xy[] = "xy*|z";
+static constexpr char ct_log[] = "(ERROR|WARN) \\[[0-9]+\\]: .*";
+static constexpr char ct_id[] = "[a-zA-Z_]\\w*";
+static constexpr char ct_ab[] = "(a|b)*a(a|b)(a|b)";
+static constexpr fa::ct::Expr ct_number = fa::ct::concat(
+    fa::ct::opt('-'), fa::ct::oneOrMore(fa::ct::range('0', '9')), fa::ct::opt(fa::ct::concat('.', fa::ct::oneOrMore(fa::ct::range('0', '9'))))
+);
+
+static void test_ct()
+{
+    cout << __func__ << ": ";
+
+    // everything below is evaluated by the compiler
+    constexpr auto xy = fa::ct::compile<ct_xy>();
+    static_assert(xy.matches("x") && xy.matches("xyyy") && xy.matches("z"));
+    static_assert(!xy.matches("") && !xy.matches("zy") && !xy.matches("y"));
+    static_assert(xy.longest_match("xyyz") == 3 && !xy.longest_match("y"));
+
+    constexpr auto number = fa::ct::compile<ct_number>();
+    static_assert(number.matches("-12.5") && number.matches("7") && !number.matches("1.") && !number.matches("-"));
+
+    // the DFA (not minimized: the 8 subsets of the last 3 bytes, the starting and the dead states)
+    // is a few byte arrays sized to fit, baked in at compile time
+    constexpr auto ab = fa::ct::compile<ct_ab>();
+    static_assert(ab.get_state_count() == 10 && ab.get_class_count() == 3);
+    static_assert(sizeof(ab) == 256 + 10 * 3 + 10);
+
+    // same language as the runtime compiled pattern
+    auto check = [](const auto& dfa, string_view pattern, string_view alphabet) {
+        NFA nfa = fa::nfa::compile(pattern);
+        srand(22);
+        for (size_t i = 0; i < 500; i++) {
+            string input;
+            for (size_t j = rand() % 12; j > 0; j--) {
+                input.push_back(alphabet[rand() % alphabet.size()]);
+            }
+            assert(dfa.matches(input) == nfa.matches(input));
+        }
+    };
+    check(xy, ct_xy, "xyz");
+    check(ab, ct_ab, "ab");
+    check(fa::ct::compile<ct_log>(), ct_log, "ERWAN []0-9:");
+    check(fa::ct::compile<ct_id>(), ct_id, "aZ_9-");
+
+    cout << "OK.\n";
+}
+
 int main()
 {
     // NFA Building Blocks Tests
@@ -338,10 +1476,43 @@ int main()
     test_optimizations_operator_plus();
     test_optimizations_operator_question_mark();
     test_optimizations_operator_char_range();
+    test_char_class();
+    test_compile();
+    test_repeat();
 
     // NFA Table Generation Tests
     test_epsilon_closure();
     test_get_transitions_table();
 
+    // NFA Graph Tests
+    test_sparse_set();
+    test_graph();
+    test_automaton();
+
+    // NFA Simulation Tests
+    test_simulator();
+    test_shift_and();
+    test_find();
+
+    // DFA Tests
+    test_dfa_table();
+    test_dfa_minimization();
+    test_byte_classes();
+    test_reverse();
+    test_required_literals();
+    test_dfa_search();
+    test_regex_set();
+    test_teddy();
+    test_lazy_dfa();
+    test_table_serialization();
+    test_codegen();
+    test_jit();
+
+    // Glushkov Tests
+    test_glushkov();
+
+    // Compile-Time Tests
+    test_ct();
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,473 @@
+/**
+ * fa-benchmark: construction time, memory and matching throughput of every construction and engine.
+ *
+ * Usage: fa-benchmark [--format json|csv] [--size BYTES] [--density FRACTION] [--seed N] [--repeat N]
+ *
+ * Matching runs over a synthetic log corpus of about BYTES bytes, where a DENSITY fraction of the
+ * lines match the benchmarked pattern (the others are near misses and random words), generated
+ * from SEED so runs are comparable. Every measure is the best of REPEAT runs.
+ *
+ * Every result is a row with the same columns, written to the standard output as a JSON array or
+ * as CSV:
+ * - group: construction (naive versus optimized NFA operators), match (whole lines) or search
+ * - name, variant: the construction or pattern, and the engine or operator variant
+ * - build_seconds, memory_bytes: time and peak heap growth of a single construction
+ * - states: states of the automaton the engine runs (for the lazy DFA, the ones cached by the
+ *   matching pass), null in JSON and empty in CSV when the engine doesn't tell
+ * - input_bytes, match_seconds, mb_per_s, matches: the matching pass over the whole corpus
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fa/ct/regex.h>
+#include <fa/dfa/dfa.h>
+#include <fa/dfa/jit.h>
+#include <fa/dfa/lazy.h>
+#include <fa/dfa/mapped.h>
+#include <fa/dfa/search.h>
+#include <fa/match.h>
+#include <fa/nfa/automaton.h>
+#include <fa/nfa/nfa.h>
+#include <fa/nfa/parser.h>
+#include <fa/nfa/shift_and.h>
+#include <fa/nfa/simulator.h>
+
+#include "matchers_goto.h"
+#include "matchers_table.h"
+
+using namespace std;
+using namespace fa::nfa;
+
+// heap usage, counted by the replaced global operator new and delete (the benchmark is single threaded)
+static size_t live_bytes = 0;
+static size_t peak_bytes = 0;
+
+// every block is prefixed by its size, keeping the default alignment
+static constexpr size_t BLOCK_HEADER = alignof(max_align_t);
+
+void* operator new(size_t size)
+{
+    auto* block = static_cast<unsigned char*>(malloc(size + BLOCK_HEADER));
+    if (!block) {
+        throw bad_alloc{};
+    }
+    *reinterpret_cast<size_t*>(block) = size;
+    live_bytes += size;
+    peak_bytes = max(peak_bytes, live_bytes);
+    return block + BLOCK_HEADER;
+}
+
+void operator delete(void* pointer) noexcept
+{
+    if (!pointer) {
+        return;
+    }
+    auto* block = static_cast<unsigned char*>(pointer) - BLOCK_HEADER;
+    live_bytes -= *reinterpret_cast<size_t*>(block);
+    free(block);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+// the pattern of the match and search groups, also compiled by fa-codegen and fa::ct
+static constexpr char log_error_pattern[] = "ERROR [0-9]+: .*";
+static_assert(string_view{ log_error_pattern } == goto_matchers::log_error_pattern);
+
+struct Options {
+    string format = "json";
+    size_t size = 4 << 20;
+    double density = 0.01;
+    unsigned seed = 24;
+    size_t repeat = 3;
+};
+
+struct Row {
+    string group;
+    string name;
+    string variant;
+    double build_seconds = 0;
+    size_t memory_bytes = 0;
+    optional<size_t> states = nullopt;
+    size_t input_bytes = 0;
+    double match_seconds = 0;
+    size_t matches = 0;
+
+    [[nodiscard]]
+    double mb_per_s() const
+    {
+        return this->match_seconds > 0 ? static_cast<double>(this->input_bytes) / this->match_seconds / 1e6 : 0;
+    }
+};
+
+struct Corpus {
+    string text;
+    vector<string_view> lines;
+    size_t matching_lines = 0;
+};
+
+/**
+ * Log lines: a density fraction of "ERROR <number>: <words>", the others "ERROR <words>" (near
+ * misses), "WARN <number>: <words>" or plain words.
+ */
+static Corpus generate_corpus(const Options& options)
+{
+    Corpus corpus;
+    mt19937 random{ options.seed };
+    uniform_real_distribution<double> uniform{ 0, 1 };
+    auto words = [&](size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            for (size_t length = 2 + random() % 8; length > 0; length--) {
+                corpus.text.push_back(static_cast<char>('a' + random() % 26));
+            }
+            corpus.text.push_back(' ');
+        }
+    };
+
+    vector<pair<size_t, size_t>> spans;
+    while (corpus.text.size() < options.size) {
+        size_t start = corpus.text.size();
+        if (uniform(random) < options.density) {
+            corpus.text += "ERROR " + to_string(random() % 100000) + ": ";
+            corpus.matching_lines++;
+        } else if (random() % 2) {
+            corpus.text += random() % 2 ? "ERROR " : "WARN " + to_string(random() % 1000) + ": ";
+        }
+        words(4 + random() % 10);
+        spans.emplace_back(start, corpus.text.size() - start);
+        corpus.text.push_back('\n');
+    }
+
+    string_view text = corpus.text;
+    for (const auto& [start, size]: spans) {
+        corpus.lines.push_back(text.substr(start, size));
+    }
+    return corpus;
+}
+
+/**
+ * Best time of the given number of runs, in seconds.
+ */
+static double best_of(size_t repeat, const function<void()>& run)
+{
+    double best = numeric_limits<double>::infinity();
+    for (size_t i = 0; i < max<size_t>(repeat, 1); i++) {
+        auto start = chrono::steady_clock::now();
+        run();
+        best = min(best, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+/**
+ * A serialized table matched in place, as if mapped from a file.
+ */
+struct ViewEngine {
+    // the view needs 8 bytes aligned data
+    vector<uint64_t> data;
+    fa::dfa::TableView view;
+
+    static vector<uint64_t> aligned_copy(const string& serialized)
+    {
+        vector<uint64_t> data((serialized.size() + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+        memcpy(data.data(), serialized.data(), serialized.size());
+        return data;
+    }
+
+    explicit ViewEngine(const string& serialized)
+        : data(aligned_copy(serialized))
+        , view(data.data(), serialized.size())
+    {
+    }
+
+    [[nodiscard]]
+    bool matches(string_view input) const
+    {
+        return this->view.matches(input);
+    }
+};
+
+/**
+ * A matcher function generated by fa-codegen.
+ */
+struct GeneratedEngine {
+    bool (*matcher)(string_view) noexcept;
+    // of the table it was generated from
+    size_t states;
+
+    [[nodiscard]]
+    bool matches(string_view input) const
+    {
+        return this->matcher(input);
+    }
+};
+
+/**
+ * States of the automaton run by an engine, when it tells.
+ */
+template <typename Engine>
+static optional<size_t> engine_states(const Engine&)
+{
+    return nullopt;
+}
+
+static optional<size_t> engine_states(const fa::dfa::Table& table)
+{
+    return table.get_state_count();
+}
+
+static optional<size_t> engine_states(const fa::dfa::Jit& jit)
+{
+    return jit.get_table().get_state_count();
+}
+
+static optional<size_t> engine_states(const fa::dfa::LazyDFA& lazy)
+{
+    return lazy.get_state_count();
+}
+
+template <size_t StateCount, size_t ClassCount>
+static optional<size_t> engine_states(const fa::ct::DFA<StateCount, ClassCount>& dfa)
+{
+    return dfa.get_state_count();
+}
+
+static optional<size_t> engine_states(const ViewEngine& engine)
+{
+    return engine.view.get_state_count();
+}
+
+static optional<size_t> engine_states(const GeneratedEngine& engine)
+{
+    return engine.states;
+}
+
+/**
+ * Builds an engine (timing it and counting its heap usage) and matches every corpus line with it.
+ */
+template <typename Build>
+static Row bench_lines(const Options& options, const Corpus& corpus, const string& variant, Build build)
+{
+    Row row{ "match", "log_error", variant };
+    row.build_seconds = best_of(options.repeat, [&]() { build(); });
+
+    size_t baseline = live_bytes;
+    peak_bytes = live_bytes;
+    auto engine = build();
+    row.memory_bytes = peak_bytes - baseline;
+
+    row.input_bytes = corpus.text.size();
+    row.match_seconds = best_of(options.repeat, [&]() {
+        row.matches = 0;
+        for (string_view line: corpus.lines) {
+            row.matches += engine.matches(line);
+        }
+    });
+    row.states = engine_states(engine);
+    return row;
+}
+
+/**
+ * Searches all non-overlapping matches of the whole corpus with the given engine (having a find(input, from)).
+ */
+template <typename Engine>
+static Row bench_search(const Options& options, const Corpus& corpus, const string& variant, const function<Engine()>& build)
+{
+    Row row{ "search", "log_error", variant };
+    row.build_seconds = best_of(options.repeat, [&]() { build(); });
+
+    size_t baseline = live_bytes;
+    peak_bytes = live_bytes;
+    Engine engine = build();
+    row.memory_bytes = peak_bytes - baseline;
+
+    row.input_bytes = corpus.text.size();
+    row.match_seconds = best_of(options.repeat, [&]() {
+        row.matches = 0;
+        for (fa::Match match: fa::Matches<Engine&>{ engine, corpus.text }) {
+            (void) match;
+            row.matches++;
+        }
+    });
+    row.states = engine_states(engine);
+    return row;
+}
+
+/**
+ * A naive versus optimized NFA operator: the time and memory of building the NFA, its size, and the
+ * NFA Simulator throughput on the corpus lines.
+ */
+static Row bench_construction(const Options& options, const Corpus& corpus, const string& name, const string& variant, const function<NFA()>& build)
+{
+    // NFA operators are quick, so every build is timed over many of them
+    constexpr size_t BUILD_ITERATIONS = 100;
+
+    Row row{ "construction", name, variant };
+    row.build_seconds = best_of(options.repeat, [&]() {
+        for (size_t i = 0; i < BUILD_ITERATIONS; i++) {
+            NFA nfa = build();
+        }
+    }) / BUILD_ITERATIONS;
+
+    size_t baseline = live_bytes;
+    peak_bytes = live_bytes;
+    NFA nfa = build();
+    row.memory_bytes = peak_bytes - baseline;
+    row.states = Automaton{ nfa }.get_state_count();
+
+    Simulator simulator{ nfa };
+    row.input_bytes = corpus.text.size();
+    row.match_seconds = best_of(options.repeat, [&]() {
+        row.matches = 0;
+        for (string_view line: corpus.lines) {
+            row.matches += simulator.matches(line);
+        }
+    });
+    return row;
+}
+
+static vector<Row> run(const Options& options, const Corpus& corpus)
+{
+    vector<Row> rows;
+
+    // naive versus optimized operators, over [a-z ] (mostly) lines
+    auto letters = []() { return disjoint(range('a', 'z'), NFA{ ' ' }); };
+    rows.push_back(bench_construction(options, corpus, "kleene", "naive", [&]() { return kleene_naive(letters()); }));
+    rows.push_back(bench_construction(options, corpus, "kleene", "optimized", [&]() { return zeroOrMore(letters()); }));
+    rows.push_back(bench_construction(options, corpus, "char_range", "naive", []() {
+        return zeroOrMore(disjoint(char_range_naive('a', 'z'), NFA{ ' ' }));
+    }));
+    rows.push_back(bench_construction(options, corpus, "char_range", "optimized", []() {
+        return zeroOrMore(disjoint(range('a', 'z'), NFA{ ' ' }));
+    }));
+    rows.push_back(bench_construction(options, corpus, "plus", "naive", [&]() { return plus_naive(letters()); }));
+    rows.push_back(bench_construction(options, corpus, "plus", "optimized", [&]() { return oneOrMore(letters()); }));
+
+    // every engine, matching whole lines (ShiftAnd runs the states of the automaton, the Simulator
+    // the ones left once its epsilon transitions are removed)
+    const Automaton automaton{ compile(log_error_pattern) };
+    const size_t simulator_states = automaton.without_epsilons().get_state_count();
+    const size_t table_states = fa::dfa::Table{ compile(log_error_pattern) }.get_state_count();
+    rows.push_back(bench_lines(options, corpus, "simulator", []() { return Simulator{ compile(log_error_pattern) }; }));
+    rows.back().states = simulator_states;
+    if (ShiftAnd::fits(automaton)) {
+        rows.push_back(bench_lines(options, corpus, "shift_and", []() { return ShiftAnd{ Automaton{ compile(log_error_pattern) } }; }));
+        rows.back().states = automaton.get_state_count();
+    }
+    rows.push_back(bench_lines(options, corpus, "lazy_dfa", []() { return fa::dfa::LazyDFA{ compile(log_error_pattern) }; }));
+    rows.push_back(bench_lines(options, corpus, "dfa_table", []() { return fa::dfa::Table{ compile(log_error_pattern) }; }));
+    rows.push_back(bench_lines(options, corpus, "table_view", []() {
+        return ViewEngine{ fa::dfa::Table{ compile(log_error_pattern) }.serialize() };
+    }));
+    Row jit = bench_lines(options, corpus, fa::dfa::Jit::is_supported() ? "jit" : "jit_fallback", []() {
+        return fa::dfa::Jit{ fa::dfa::Table{ compile(log_error_pattern) } };
+    });
+    jit.memory_bytes += fa::dfa::Jit{ fa::dfa::Table{ compile(log_error_pattern) } }.get_code_size();
+    rows.push_back(jit);
+    rows.push_back(bench_lines(options, corpus, "codegen_goto", [&]() { return GeneratedEngine{ goto_matchers::log_error, table_states }; }));
+    rows.push_back(bench_lines(options, corpus, "codegen_table", [&]() { return GeneratedEngine{ table_matchers::log_error, table_states }; }));
+    rows.push_back(bench_lines(options, corpus, "compile_time", []() { return fa::ct::compile<log_error_pattern>(); }));
+
+    // leftmost-longest search over the whole corpus
+    rows.push_back(bench_search<Simulator>(options, corpus, "simulator", []() { return Simulator{ compile(log_error_pattern) }; }));
+    rows.back().states = simulator_states;
+    rows.push_back(bench_search<fa::dfa::Searcher>(options, corpus, "dfa_searcher", []() {
+        return fa::dfa::Searcher{ compile(log_error_pattern) };
+    }));
+
+    return rows;
+}
+
+static void write_json(ostream& os, const Options& options, const Corpus& corpus, const vector<Row>& rows)
+{
+    os << "{\n";
+    os << "  \"corpus\": {\"bytes\": " << corpus.text.size() << ", \"lines\": " << corpus.lines.size()
+       << ", \"matching_lines\": " << corpus.matching_lines << ", \"density\": " << options.density
+       << ", \"seed\": " << options.seed << "},\n";
+    os << "  \"results\": [\n";
+    for (size_t i = 0; i < rows.size(); i++) {
+        const Row& row = rows[i];
+        os << "    {\"group\": \"" << row.group << "\", \"name\": \"" << row.name << "\", \"variant\": \"" << row.variant
+           << "\", \"build_seconds\": " << row.build_seconds << ", \"memory_bytes\": " << row.memory_bytes
+           << ", \"states\": " << (row.states ? to_string(*row.states) : "null") << ", \"input_bytes\": " << row.input_bytes
+           << ", \"match_seconds\": " << row.match_seconds << ", \"mb_per_s\": " << row.mb_per_s()
+           << ", \"matches\": " << row.matches << "}" << (i + 1 < rows.size() ? "," : "") << "\n";
+    }
+    os << "  ]\n";
+    os << "}\n";
+}
+
+static void write_csv(ostream& os, const vector<Row>& rows)
+{
+    os << "group,name,variant,build_seconds,memory_bytes,states,input_bytes,match_seconds,mb_per_s,matches\n";
+    for (const Row& row: rows) {
+        os << row.group << "," << row.name << "," << row.variant << "," << row.build_seconds << ","
+           << row.memory_bytes << "," << (row.states ? to_string(*row.states) : "") << "," << row.input_bytes << "," << row.match_seconds << ","
+           << row.mb_per_s() << "," << row.matches << "\n";
+    }
+}
+
+static int usage()
+{
+    cerr << "Usage: fa-benchmark [--format json|csv] [--size BYTES] [--density FRACTION] [--seed N] [--repeat N]\n";
+    return 2;
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (i + 1 == argc) {
+            return usage();
+        }
+        string value = argv[++i];
+        if (arg == "--format" && (value == "json" || value == "csv")) {
+            options.format = value;
+        } else if (arg == "--size") {
+            options.size = stoul(value);
+        } else if (arg == "--density") {
+            options.density = stod(value);
+        } else if (arg == "--seed") {
+            options.seed = static_cast<unsigned>(stoul(value));
+        } else if (arg == "--repeat") {
+            options.repeat = stoul(value);
+        } else {
+            return usage();
+        }
+    }
+
+    Corpus corpus = generate_corpus(options);
+    vector<Row> rows = run(options, corpus);
+
+    // every engine agrees on the matches
+    for (const Row& row: rows) {
+        if (row.group != "construction" && row.matches != corpus.matching_lines) {
+            cerr << "fa-benchmark: " << row.variant << " found " << row.matches << " matches out of "
+                 << corpus.matching_lines << "\n";
+            return 1;
+        }
+    }
+
+    cout << setprecision(6);
+    if (options.format == "json") {
+        write_json(cout, options, corpus, rows);
+    } else {
+        write_csv(cout, rows);
+    }
+    return 0;
+}
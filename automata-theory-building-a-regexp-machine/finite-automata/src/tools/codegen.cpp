@@ -0,0 +1,96 @@
+/**
+ * fa-codegen: compiles patterns into a header of standalone C++ matchers.
+ *
+ * Usage: fa-codegen [--table] [--namespace NAME] OUTPUT NAME=PATTERN...
+ *
+ * Every NAME=PATTERN becomes an `inline bool NAME(std::string_view input) noexcept` function
+ * verifying if the whole input matches PATTERN (see fa::nfa::compile for its syntax), along
+ * with a `NAME_pattern` string view holding PATTERN itself.
+ */
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fa/dfa/codegen.h>
+#include <fa/dfa/dfa.h>
+#include <fa/nfa/parser.h>
+
+using namespace std;
+
+static int usage()
+{
+    cerr << "Usage: fa-codegen [--table] [--namespace NAME] OUTPUT NAME=PATTERN...\n";
+    return 2;
+}
+
+static string include_guard(const string& path)
+{
+    string guard = "FA_GENERATED_";
+    for (char c: path.substr(path.find_last_of('/') + 1)) {
+        guard.push_back(isalnum(static_cast<unsigned char>(c)) ? static_cast<char>(toupper(static_cast<unsigned char>(c))) : '_');
+    }
+    return guard;
+}
+
+int main(int argc, char** argv)
+{
+    fa::dfa::CodeStyle style = fa::dfa::CodeStyle::GOTO;
+    string namespace_name;
+    vector<string> args;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--table") {
+            style = fa::dfa::CodeStyle::TABLE;
+        } else if (arg == "--namespace" && i + 1 < argc) {
+            namespace_name = argv[++i];
+        } else {
+            args.push_back(arg);
+        }
+    }
+    if (args.size() < 2) {
+        return usage();
+    }
+
+    ofstream output{ args[0] };
+    if (!output) {
+        cerr << "fa-codegen: can't write " << args[0] << "\n";
+        return 1;
+    }
+
+    string guard = include_guard(args[0]);
+    output << "// Generated by fa-codegen. Do not edit.\n";
+    output << "#ifndef " << guard << "\n";
+    output << "#define " << guard << "\n\n";
+    output << "#include <cstdint>\n";
+    output << "#include <string_view>\n\n";
+    if (!namespace_name.empty()) {
+        output << "namespace " << namespace_name << "\n{\n";
+    }
+
+    for (size_t i = 1; i < args.size(); i++) {
+        size_t separator = args[i].find('=');
+        if (separator == string::npos || separator == 0) {
+            return usage();
+        }
+        string name = args[i].substr(0, separator);
+        string pattern = args[i].substr(separator + 1);
+
+        try {
+            fa::dfa::Table table{ fa::nfa::compile(pattern) };
+            output << "\ninline constexpr std::string_view " << name << "_pattern = " << fa::dfa::string_literal(pattern) << ";\n\n";
+            fa::dfa::generate_matcher(output, table, name, style);
+        } catch (const fa::nfa::SyntaxError& error) {
+            cerr << "fa-codegen: " << name << ": " << error.what() << "\n";
+            return 1;
+        }
+    }
+
+    if (!namespace_name.empty()) {
+        output << "}\n";
+    }
+    output << "\n#endif\n";
+
+    return output ? 0 : 1;
+}
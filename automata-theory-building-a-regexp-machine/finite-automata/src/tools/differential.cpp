@@ -0,0 +1,806 @@
+/**
+ * fa-differential: checks every engine against std::regex, on random patterns and inputs.
+ *
+ * Usage: fa-differential [--patterns N] [--seed N] [--depth N]
+ *
+ * Every random pattern is built through the combinator APIs (both the Thompson NFA and the
+ * Glushkov expression), along with its textual form, which is both parsed (fa::nfa::compile) and
+ * given to std::regex (POSIX extended syntax). Every engine then matches the same inputs: random
+ * ones, adversarial ones (long runs and repetitions of the pattern bytes) and matching ones
+ * (random walks on the DFA), and any disagreement with std::regex is reported. std::regex is
+ * exponential on nested quantifiers: once it takes too long on the inputs of a pattern, its
+ * longer inputs are checked against the Thompson NFA Simulator instead.
+ *
+ * Whole input matching is compared with std::regex_match, and the leftmost-longest search with
+ * the leftmost start of std::regex_search, extended to the longest std::regex_match from it
+ * (libstdc++ doesn't always select the longest match, even with POSIX grammars).
+ *
+ * Regex sets pair the pattern with a random literal (whose expected results are plain substring
+ * checks), and so use the Teddy prefilter whenever the pattern has a required prefix. Teddy itself
+ * is checked on every instruction set the host supports, against std::string_view::find. Iterating
+ * over all matches (fa::Matches, through Searcher::find_next) is checked against iterating with the
+ * Simulator, whose first match is the one checked against std::regex.
+ *
+ * Needs a POSIX host, as std::regex runs in a child process it can kill when it gets too slow.
+ *
+ * Per engine construction and matching times are reported side by side, with the speedup over
+ * std::regex. Exits with 1 if any engine disagrees, or if more than MAX_REFERENCE_SHARE of the
+ * inputs could only be checked against the Simulator.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <fa/dfa/dfa.h>
+#include <fa/dfa/jit.h>
+#include <fa/dfa/lazy.h>
+#include <fa/dfa/mapped.h>
+#include <fa/dfa/search.h>
+#include <fa/dfa/set.h>
+#include <fa/dfa/teddy.h>
+#include <fa/glushkov/expr.h>
+#include <fa/match.h>
+#include <fa/nfa/automaton.h>
+#include <fa/nfa/literals.h>
+#include <fa/nfa/matcher.h>
+#include <fa/nfa/nfa.h>
+#include <fa/nfa/parser.h>
+#include <fa/nfa/shift_and.h>
+#include <fa/nfa/simulator.h>
+
+using namespace std;
+using namespace fa::nfa;
+
+namespace g = fa::glushkov;
+
+/**
+ * The same random pattern, as a Thompson NFA, a Glushkov expression and text.
+ */
+struct Pattern {
+    NFA nfa;
+    g::Expr expr;
+    string text;
+};
+
+/**
+ * Random patterns over the "abc" alphabet.
+ */
+class PatternGenerator
+{
+protected:
+    mt19937& random;
+
+    size_t pick(size_t count)
+    {
+        return uniform_int_distribution<size_t>{ 0, count - 1 }(this->random);
+    }
+
+    /**
+     * The expression repeated min to max times (max + 1 meaning unbounded), expanded for Glushkov.
+     */
+    static g::Expr repeat_expr(const g::Expr& expr, size_t min_count, size_t max_count, bool unbounded)
+    {
+        g::Expr resulting;
+        for (size_t i = 0; i < min_count; i++) {
+            resulting = g::concat(resulting, expr);
+        }
+        if (unbounded) {
+            return g::concat(resulting, g::zeroOrMore(expr));
+        }
+        g::Expr optional;
+        for (size_t i = min_count; i < max_count; i++) {
+            optional = g::opt(g::concat(expr, optional));
+        }
+        return g::concat(resulting, optional);
+    }
+
+public:
+    explicit PatternGenerator(mt19937& random)
+        : random(random)
+    {
+    }
+
+    Pattern generate(size_t depth)
+    {
+        size_t kind = depth == 0 ? this->pick(2) : this->pick(8);
+        switch (kind) {
+        case 0: {
+            char c = static_cast<char>('a' + this->pick(3));
+            return Pattern{ NFA{ c }, g::Expr{ c }, string(1, c) };
+        }
+        case 1: {
+            char from = static_cast<char>('a' + this->pick(3));
+            char to = static_cast<char>(from + this->pick(static_cast<size_t>('c' - from) + 1));
+            return Pattern{ range(from, to), g::range(from, to), string{ '[', from, '-', to, ']' } };
+        }
+        case 2: {
+            Pattern a = this->generate(depth - 1);
+            Pattern b = this->generate(depth - 1);
+            return Pattern{ concat(a.nfa, b.nfa), g::concat(a.expr, b.expr), "(" + a.text + b.text + ")" };
+        }
+        case 3: {
+            Pattern a = this->generate(depth - 1);
+            Pattern b = this->generate(depth - 1);
+            return Pattern{ disjoint(a.nfa, b.nfa), g::disjoint(a.expr, b.expr), "(" + a.text + "|" + b.text + ")" };
+        }
+        case 4: {
+            Pattern a = this->generate(depth - 1);
+            return Pattern{ zeroOrMore(a.nfa), g::zeroOrMore(a.expr), "(" + a.text + ")*" };
+        }
+        case 5: {
+            Pattern a = this->generate(depth - 1);
+            return Pattern{ oneOrMore(a.nfa), g::oneOrMore(a.expr), "(" + a.text + ")+" };
+        }
+        case 6: {
+            Pattern a = this->generate(depth - 1);
+            return Pattern{ opt(a.nfa), g::opt(a.expr), "(" + a.text + ")?" };
+        }
+        default: {
+            Pattern a = this->generate(depth - 1);
+            size_t min_count = this->pick(3);
+            bool unbounded = this->pick(3) == 0;
+            size_t max_count = unbounded ? UNBOUNDED : min_count + this->pick(3);
+            string text = "(" + a.text + "){" + to_string(min_count) + (unbounded ? ",}" : "," + to_string(max_count) + "}");
+            return Pattern{ repeat(a.nfa, min_count, max_count), repeat_expr(a.expr, min_count, max_count, unbounded), text };
+        }
+        }
+    }
+};
+
+/**
+ * Random, adversarial and matching inputs for the given pattern, shortest first.
+ */
+static vector<string> generate_inputs(mt19937& random, const fa::dfa::Table& table)
+{
+    vector<string> inputs{ "" };
+    auto pick = [&](size_t count) { return uniform_int_distribution<size_t>{ 0, count - 1 }(random); };
+
+    for (size_t i = 0; i < 40; i++) {
+        string input;
+        for (size_t j = pick(16); j > 0; j--) {
+            input.push_back("abcd"[pick(4)]);
+        }
+        inputs.push_back(input);
+    }
+
+    // long runs and repetitions, where backtracking matchers blow up
+    for (size_t length: { 8, 16, 24 }) {
+        for (const char* unit: { "a", "ab", "abc", "ba" }) {
+            string run;
+            while (run.size() < length) {
+                run += unit;
+            }
+            inputs.push_back(run);
+            inputs.push_back(run + "d");
+            inputs.push_back("d" + run);
+        }
+    }
+
+    // random walks on the DFA, ending on accepting states when possible
+    for (size_t i = 0; i < 20; i++) {
+        string input;
+        uint32_t state = table.get_starting_state();
+        while (input.size() < 24 && !(table.is_accepting(state) && pick(4) == 0)) {
+            string live;
+            for (char c: string_view{ "abc" }) {
+                if (table.next(state, static_cast<unsigned char>(c)) != fa::dfa::Table::DEAD_STATE) {
+                    live.push_back(c);
+                }
+            }
+            if (live.empty()) {
+                break;
+            }
+            input.push_back(live[pick(live.size())]);
+            state = table.next(state, static_cast<unsigned char>(input.back()));
+        }
+        inputs.push_back(input);
+    }
+
+    stable_sort(inputs.begin(), inputs.end(), [](const string& a, const string& b) { return a.size() < b.size(); });
+    return inputs;
+}
+
+/**
+ * Time and calls of an engine, over all patterns.
+ */
+struct Timing {
+    string engine;
+    double build_seconds = 0;
+    double match_seconds = 0;
+    size_t calls = 0;
+};
+
+static double seconds_since(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * The std::regex verdict on an input.
+ */
+struct BaselineResult {
+    size_t input;
+    bool matched;
+    bool found;
+    size_t start;
+    size_t end;
+    double match_seconds;
+    double search_seconds;
+};
+
+/**
+ * Above this (wall) time for all the inputs of a pattern, std::regex is stopped. With POSIX
+ * grammars it explores every path, which is exponential on nested quantifiers.
+ */
+static constexpr int BASELINE_PATTERN_MILLISECONDS = 100;
+
+static BaselineResult baseline_result(const regex& baseline, const vector<string>& inputs, size_t i)
+{
+    BaselineResult result{ i, false, false, 0, 0, 0, 0 };
+    const string& input = inputs[i];
+
+    auto start = chrono::steady_clock::now();
+    result.matched = regex_match(input, baseline);
+    result.match_seconds = seconds_since(start);
+
+    start = chrono::steady_clock::now();
+    smatch match;
+    result.found = regex_search(input, match, baseline);
+    result.search_seconds = seconds_since(start);
+
+    // the leftmost start is the same with any grammar, but libstdc++ doesn't always pick the
+    // longest match from it, so the longest one is looked for with regex_match
+    if (result.found) {
+        result.start = static_cast<size_t>(match.position(0));
+        result.end = input.size();
+        while (result.end > result.start && !regex_match(input.begin() + static_cast<ptrdiff_t>(result.start), input.begin() + static_cast<ptrdiff_t>(result.end), baseline)) {
+            result.end--;
+        }
+    }
+    return result;
+}
+
+/**
+ * The std::regex verdicts on the (shortest first) inputs, until it gets too slow.
+ *
+ * A std::regex call can't be interrupted, so they run in a child process streaming its results,
+ * killed after BASELINE_PATTERN_MILLISECONDS. It also stops when std::regex gives up (throwing
+ * error_complexity or error_stack).
+ */
+static vector<BaselineResult> run_baseline(const regex& baseline, const vector<string>& inputs)
+{
+    vector<BaselineResult> results;
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return results;
+    }
+    pid_t child = fork();
+    if (child < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return results;
+    }
+    if (child == 0) {
+        close(fds[0]);
+        for (size_t i = 0; i < inputs.size(); i++) {
+            try {
+                BaselineResult result = baseline_result(baseline, inputs, i);
+                if (write(fds[1], &result, sizeof(result)) != static_cast<ssize_t>(sizeof(result))) {
+                    break;
+                }
+            } catch (const regex_error&) {
+                break;
+            }
+        }
+        _exit(0);
+    }
+
+    close(fds[1]);
+    auto deadline = chrono::steady_clock::now() + chrono::milliseconds{ BASELINE_PATTERN_MILLISECONDS };
+    vector<unsigned char> buffer;
+    while (true) {
+        auto remaining = chrono::duration_cast<chrono::milliseconds>(deadline - chrono::steady_clock::now()).count();
+        pollfd poll_fd{ fds[0], POLLIN, 0 };
+        if (remaining <= 0 || poll(&poll_fd, 1, static_cast<int>(remaining)) <= 0) {
+            break;
+        }
+        unsigned char chunk[4096];
+        ssize_t size = read(fds[0], chunk, sizeof(chunk));
+        if (size <= 0) {
+            break;
+        }
+        buffer.insert(buffer.end(), chunk, chunk + size);
+    }
+    kill(child, SIGKILL);
+    waitpid(child, nullptr, 0);
+    close(fds[0]);
+
+    for (size_t offset = 0; offset + sizeof(BaselineResult) <= buffer.size(); offset += sizeof(BaselineResult)) {
+        BaselineResult result;
+        memcpy(&result, buffer.data() + offset, sizeof(result));
+        results.push_back(result);
+    }
+    return results;
+}
+
+/**
+ * Above this share of inputs checked against the NFA Simulator rather than std::regex, the
+ * engines are mostly compared with the library itself, and the run fails (lower --depth).
+ */
+static constexpr double MAX_REFERENCE_SHARE = 0.1;
+
+/**
+ * Runs every engine over the inputs of every pattern, comparing them with std::regex.
+ */
+class Harness
+{
+protected:
+    // references to its timings stay valid while adding engines
+    deque<Timing> timings;
+    size_t disagreements = 0;
+    size_t baseline_checks = 0;
+    size_t reference_checks = 0;
+    size_t prefiltered_sets = 0;
+
+    Timing& timing(const string& engine)
+    {
+        for (Timing& timing: this->timings) {
+            if (timing.engine == engine) {
+                return timing;
+            }
+        }
+        return this->timings.emplace_back(Timing{ engine });
+    }
+
+    void report(const Pattern& pattern, const string& engine, const string& input, const string& expected, const string& got)
+    {
+        if (++this->disagreements <= 20) {
+            cerr << "DISAGREEMENT: " << engine << " on /" << pattern.text << "/ input \"" << input << "\": expected "
+                 << expected << ", got " << got << "\n";
+        }
+    }
+
+    static string describe(optional<fa::Match> match)
+    {
+        return match ? "[" + to_string(match->start) + ", " + to_string(match->end) + ")" : "none";
+    }
+
+    static string describe(const vector<fa::Match>& matches)
+    {
+        string described;
+        for (const fa::Match& match: matches) {
+            described += describe(match);
+        }
+        return matches.empty() ? "none" : described;
+    }
+
+    static string describe(const vector<size_t>& patterns)
+    {
+        string described = "{";
+        for (size_t pattern: patterns) {
+            described += (described.size() > 1 ? ", " : "") + to_string(pattern);
+        }
+        return described + "}";
+    }
+
+    static string describe_position(size_t position)
+    {
+        return position == string_view::npos ? "none" : to_string(position);
+    }
+
+    static string random_literal(mt19937& random)
+    {
+        string literal(1 + uniform_int_distribution<size_t>{ 0, 2 }(random), 'a');
+        for (char& c: literal) {
+            c = "abc"[uniform_int_distribution<size_t>{ 0, 2 }(random)];
+        }
+        return literal;
+    }
+
+    /**
+     * Whole input matching, with an engine built by the given function.
+     */
+    template <typename Build>
+    void check_matches(const Pattern& pattern, const vector<string>& inputs, const vector<optional<bool>>& expected, const string& engine, Build build)
+    {
+        Timing& timing = this->timing(engine);
+        auto start = chrono::steady_clock::now();
+        auto matcher = build();
+        timing.build_seconds += seconds_since(start);
+
+        vector<bool> results(inputs.size());
+        start = chrono::steady_clock::now();
+        for (size_t i = 0; i < inputs.size(); i++) {
+            results[i] = matcher.matches(inputs[i]);
+        }
+        timing.match_seconds += seconds_since(start);
+        timing.calls += inputs.size();
+
+        for (size_t i = 0; i < inputs.size(); i++) {
+            if (expected[i] && *expected[i] != results[i]) {
+                this->report(pattern, engine, inputs[i], *expected[i] ? "match" : "no match", results[i] ? "match" : "no match");
+            }
+        }
+    }
+
+    /**
+     * Leftmost-longest search, with an engine built by the given function.
+     */
+    template <typename Build>
+    void check_find(const Pattern& pattern, const vector<string>& inputs, const vector<optional<optional<fa::Match>>>& expected, const string& engine, Build build)
+    {
+        Timing& timing = this->timing(engine);
+        auto start = chrono::steady_clock::now();
+        auto searcher = build();
+        timing.build_seconds += seconds_since(start);
+
+        vector<optional<fa::Match>> results(inputs.size());
+        start = chrono::steady_clock::now();
+        for (size_t i = 0; i < inputs.size(); i++) {
+            results[i] = searcher.find(inputs[i]);
+        }
+        timing.match_seconds += seconds_since(start);
+        timing.calls += inputs.size();
+
+        for (size_t i = 0; i < inputs.size(); i++) {
+            if (expected[i] && !(*expected[i] == results[i])) {
+                this->report(pattern, engine, inputs[i], describe(*expected[i]), describe(results[i]));
+            }
+        }
+    }
+
+    /**
+     * Whole input matching and search of a set of the pattern (index 0) and a literal (index 1).
+     */
+    void check_set(const Pattern& pattern, const vector<string>& inputs, const vector<optional<bool>>& expected_matches, const vector<optional<optional<fa::Match>>>& expected_finds, const string& literal)
+    {
+        NFA literal_nfa{ literal[0] };
+        for (char c: string_view{ literal }.substr(1)) {
+            literal_nfa = concat(literal_nfa, NFA{ c });
+        }
+
+        Timing& timing = this->timing("dfa::RegexSet");
+        auto start = chrono::steady_clock::now();
+        fa::dfa::RegexSet set{ { pattern.nfa, literal_nfa } };
+        timing.build_seconds += seconds_since(start);
+        if (set.get_prefilter()) {
+            this->prefiltered_sets++;
+        }
+
+        vector<vector<size_t>> matches(inputs.size());
+        start = chrono::steady_clock::now();
+        for (size_t i = 0; i < inputs.size(); i++) {
+            matches[i] = set.matches(inputs[i]);
+        }
+        timing.match_seconds += seconds_since(start);
+        timing.calls += inputs.size();
+
+        Timing& search_timing = this->timing("dfa::RegexSet::search");
+        vector<vector<size_t>> searches(inputs.size());
+        start = chrono::steady_clock::now();
+        for (size_t i = 0; i < inputs.size(); i++) {
+            searches[i] = set.search(inputs[i]);
+        }
+        search_timing.match_seconds += seconds_since(start);
+        search_timing.calls += inputs.size();
+
+        for (size_t i = 0; i < inputs.size(); i++) {
+            if (expected_matches[i]) {
+                vector<size_t> expected;
+                if (*expected_matches[i]) {
+                    expected.push_back(0);
+                }
+                if (inputs[i] == literal) {
+                    expected.push_back(1);
+                }
+                if (matches[i] != expected) {
+                    this->report(pattern, "dfa::RegexSet /" + literal + "/", inputs[i], describe(expected), describe(matches[i]));
+                }
+            }
+            if (expected_finds[i]) {
+                vector<size_t> expected;
+                if (expected_finds[i]->has_value()) {
+                    expected.push_back(0);
+                }
+                if (inputs[i].find(literal) != string::npos) {
+                    expected.push_back(1);
+                }
+                if (searches[i] != expected) {
+                    this->report(pattern, "dfa::RegexSet::search /" + literal + "/", inputs[i], describe(expected), describe(searches[i]));
+                }
+            }
+        }
+    }
+
+    /**
+     * Every occurrence found by Teddy, on every instruction set the host supports.
+     */
+    void check_teddy(const Pattern& pattern, const vector<string>& inputs, const vector<string>& literals)
+    {
+        // the vector paths only run on inputs longer than their registers
+        vector<string> checked = inputs;
+        string all;
+        for (const string& input: inputs) {
+            all += input;
+        }
+        checked.push_back(all);
+
+        auto expected_find = [&](string_view input, size_t from) {
+            size_t position = string_view::npos;
+            for (const string& literal: literals) {
+                position = min(position, input.find(literal, from));
+            }
+            return position;
+        };
+
+        using Isa = fa::dfa::Teddy::Isa;
+        for (auto [isa, name]: { pair{ Isa::SCALAR, "scalar" }, pair{ Isa::SSSE3, "ssse3" }, pair{ Isa::AVX2, "avx2" } }) {
+            if (isa > fa::dfa::Teddy::detect_isa()) {
+                continue;
+            }
+            const string engine = string{ "dfa::Teddy::find (" } + name + ")";
+            Timing& timing = this->timing(engine);
+            auto start = chrono::steady_clock::now();
+            fa::dfa::Teddy teddy{ literals, isa };
+            timing.build_seconds += seconds_since(start);
+
+            for (const string& input: checked) {
+                for (size_t from = 0; from <= input.size(); from++) {
+                    start = chrono::steady_clock::now();
+                    size_t position = teddy.find(input, from);
+                    timing.match_seconds += seconds_since(start);
+                    timing.calls++;
+                    if (size_t expected = expected_find(input, from); position != expected) {
+                        this->report(pattern, engine + " from " + to_string(from), input, describe_position(expected), describe_position(position));
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * All successive matches of the DFA Searcher (through find_next), with those of the Simulator.
+     */
+    void check_all_matches(const Pattern& pattern, const vector<string>& inputs)
+    {
+        Simulator reference{ pattern.nfa };
+        Timing& timing = this->timing("dfa::Searcher::find_next");
+        auto start = chrono::steady_clock::now();
+        fa::dfa::Searcher searcher{ pattern.nfa };
+        timing.build_seconds += seconds_since(start);
+
+        for (const string& input: inputs) {
+            vector<fa::Match> expected;
+            for (fa::Match match: fa::Matches<Simulator&>{ reference, input }) {
+                expected.push_back(match);
+            }
+
+            vector<fa::Match> results;
+            start = chrono::steady_clock::now();
+            for (fa::Match match: fa::Matches<fa::dfa::Searcher&>{ searcher, input }) {
+                results.push_back(match);
+            }
+            timing.match_seconds += seconds_since(start);
+            timing.calls++;
+
+            if (results != expected) {
+                this->report(pattern, "dfa::Searcher::find_next", input, describe(expected), describe(results));
+            }
+        }
+    }
+
+public:
+    /**
+     * Checks all engines on the given pattern. Returns false if std::regex rejects it.
+     */
+    bool check(const Pattern& pattern, mt19937& random)
+    {
+        Timing& baseline_match = this->timing("std::regex_match");
+        Timing& baseline_search = this->timing("std::regex_search");
+        auto start = chrono::steady_clock::now();
+        optional<regex> baseline;
+        try {
+            baseline.emplace(pattern.text, regex::extended);
+        } catch (const regex_error&) {
+            return false;
+        }
+        baseline_match.build_seconds += seconds_since(start);
+
+        fa::dfa::Table table{ pattern.nfa };
+        vector<string> inputs = generate_inputs(random, table);
+
+        vector<optional<bool>> expected_matches(inputs.size());
+        vector<optional<optional<fa::Match>>> expected_finds(inputs.size());
+        for (const BaselineResult& result: run_baseline(*baseline, inputs)) {
+            expected_matches[result.input] = result.matched;
+            expected_finds[result.input] = result.found ? optional<fa::Match>{ fa::Match{ result.start, result.end } } : nullopt;
+            baseline_match.match_seconds += result.match_seconds;
+            baseline_match.calls++;
+            baseline_search.match_seconds += result.search_seconds;
+            baseline_search.calls++;
+        }
+
+        Simulator reference{ pattern.nfa };
+        for (size_t i = 0; i < inputs.size(); i++) {
+            if (expected_matches[i]) {
+                this->baseline_checks++;
+                continue;
+            }
+            expected_matches[i] = reference.matches(inputs[i]);
+            expected_finds[i] = reference.find(inputs[i]);
+            this->reference_checks++;
+        }
+
+        const NFA& nfa = pattern.nfa;
+        this->check_matches(pattern, inputs, expected_matches, "nfa::compile", [&]() { return Simulator{ compile(pattern.text) }; });
+        this->check_matches(pattern, inputs, expected_matches, "nfa::Simulator", [&]() { return Simulator{ nfa }; });
+        this->check_matches(pattern, inputs, expected_matches, "nfa::Matcher", [&]() { return Matcher{ nfa }; });
+        this->check_matches(pattern, inputs, expected_matches, "glushkov", [&]() { return Simulator{ g::compile(pattern.expr) }; });
+        if (Automaton automaton{ nfa }; ShiftAnd::fits(automaton)) {
+            this->check_matches(pattern, inputs, expected_matches, "nfa::ShiftAnd", [&]() { return ShiftAnd{ automaton }; });
+        }
+        this->check_matches(pattern, inputs, expected_matches, "dfa::LazyDFA", [&]() { return fa::dfa::LazyDFA{ nfa }; });
+        this->check_matches(pattern, inputs, expected_matches, "dfa::Table", [&]() { return fa::dfa::Table{ nfa }; });
+        this->check_matches(pattern, inputs, expected_matches, "dfa::TableView", [&]() {
+            struct View {
+                vector<uint64_t> data;
+                fa::dfa::TableView view;
+
+                bool matches(string_view input) const
+                {
+                    return this->view.matches(input);
+                }
+            };
+            string serialized = fa::dfa::Table{ nfa }.serialize();
+            // the view needs 8 bytes aligned data
+            vector<uint64_t> data((serialized.size() + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+            memcpy(data.data(), serialized.data(), serialized.size());
+            fa::dfa::TableView view{ data.data(), serialized.size() };
+            return View{ move(data), view };
+        });
+        this->check_matches(pattern, inputs, expected_matches, "dfa::Jit", [&]() { return fa::dfa::Jit{ fa::dfa::Table{ nfa } }; });
+
+        this->check_find(pattern, inputs, expected_finds, "nfa::Simulator::find", [&]() { return Simulator{ nfa }; });
+        this->check_find(pattern, inputs, expected_finds, "dfa::Searcher::find", [&]() { return fa::dfa::Searcher{ nfa }; });
+        this->check_all_matches(pattern, inputs);
+
+        string literal = random_literal(random);
+        this->check_set(pattern, inputs, expected_matches, expected_finds, literal);
+        vector<string> literals{ literal };
+        if (string prefix = fa::nfa::required_literals(Automaton{ nfa }).prefix; !prefix.empty()) {
+            literals.push_back(prefix);
+        }
+        this->check_teddy(pattern, inputs, literals);
+        return true;
+    }
+
+    void print_timings(ostream& os) const
+    {
+        double baseline_match = 0;
+        double baseline_search = 0;
+        for (const Timing& timing: this->timings) {
+            if (timing.engine == "std::regex_match") {
+                baseline_match = timing.match_seconds / static_cast<double>(timing.calls);
+            } else if (timing.engine == "std::regex_search") {
+                baseline_search = timing.match_seconds / static_cast<double>(timing.calls);
+            }
+        }
+
+        os << left << setw(28) << "engine" << right << setw(12) << "calls" << setw(14) << "build ms"
+           << setw(14) << "match ms" << setw(12) << "ns/call" << setw(14) << "vs std::regex" << "\n";
+        for (const Timing& timing: this->timings) {
+            double per_call = timing.calls ? timing.match_seconds / static_cast<double>(timing.calls) : 0;
+            bool search = timing.engine.find("find") != string::npos || timing.engine.find("search") != string::npos;
+            double speedup = per_call > 0 ? (search ? baseline_search : baseline_match) / per_call : 0;
+            os << left << setw(28) << timing.engine << right << setw(12) << timing.calls
+               << setw(14) << fixed << setprecision(3) << timing.build_seconds * 1e3
+               << setw(14) << timing.match_seconds * 1e3
+               << setw(12) << setprecision(1) << per_call * 1e9
+               << setw(13) << setprecision(2) << speedup << "x\n";
+        }
+    }
+
+    [[nodiscard]]
+    size_t get_disagreements() const
+    {
+        return this->disagreements;
+    }
+
+    /**
+     * Number of inputs checked against std::regex.
+     */
+    [[nodiscard]]
+    size_t get_baseline_checks() const
+    {
+        return this->baseline_checks;
+    }
+
+    /**
+     * Number of inputs checked against the NFA Simulator, as std::regex was too slow.
+     */
+    [[nodiscard]]
+    size_t get_reference_checks() const
+    {
+        return this->reference_checks;
+    }
+
+    /**
+     * Number of regex sets searched with the Teddy prefilter.
+     */
+    [[nodiscard]]
+    size_t get_prefiltered_sets() const
+    {
+        return this->prefiltered_sets;
+    }
+};
+
+static int usage()
+{
+    cerr << "Usage: fa-differential [--patterns N] [--seed N] [--depth N]\n";
+    return 2;
+}
+
+int main(int argc, char** argv)
+{
+    size_t pattern_count = 300;
+    unsigned seed = 25;
+    size_t depth = 4;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string arg = argv[i];
+        if (arg == "--patterns") {
+            pattern_count = stoul(argv[i + 1]);
+        } else if (arg == "--seed") {
+            seed = static_cast<unsigned>(stoul(argv[i + 1]));
+        } else if (arg == "--depth") {
+            depth = stoul(argv[i + 1]);
+        } else {
+            return usage();
+        }
+    }
+    if (argc % 2 == 0) {
+        return usage();
+    }
+
+    mt19937 random{ seed };
+    PatternGenerator generator{ random };
+    Harness harness;
+    size_t rejected = 0;
+    for (size_t i = 0; i < pattern_count; i++) {
+        Pattern pattern = generator.generate(1 + i % depth);
+        if (!harness.check(pattern, random)) {
+            rejected++;
+        }
+    }
+
+    cout << pattern_count << " patterns (" << rejected << " rejected by std::regex), "
+         << harness.get_baseline_checks() << " inputs checked against std::regex, "
+         << harness.get_reference_checks() << " against the NFA Simulator (std::regex too slow), "
+         << harness.get_prefiltered_sets() << " regex sets prefiltered by Teddy, "
+         << harness.get_disagreements() << " disagreements\n\n";
+    harness.print_timings(cout);
+
+    size_t checks = harness.get_baseline_checks() + harness.get_reference_checks();
+    double reference_share = checks ? static_cast<double>(harness.get_reference_checks()) / static_cast<double>(checks) : 0;
+    if (harness.get_reference_checks() > 0) {
+        cerr << "\nwarning: " << fixed << setprecision(1) << reference_share * 100
+             << "% of the inputs were only checked against the NFA Simulator (at most "
+             << MAX_REFERENCE_SHARE * 100 << "% allowed)\n";
+    }
+    return harness.get_disagreements() == 0 && reference_share <= MAX_REFERENCE_SHARE ? 0 : 1;
+}
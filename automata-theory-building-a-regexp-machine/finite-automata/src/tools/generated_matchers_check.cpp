@@ -0,0 +1,52 @@
+/**
+ * Checks the matchers generated by fa-codegen at build time against the DFA tables they come from.
+ */
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include <fa/dfa/dfa.h>
+#include <fa/nfa/parser.h>
+
+#include "matchers_goto.h"
+#include "matchers_table.h"
+
+using namespace std;
+
+using Matcher = bool (*)(string_view) noexcept;
+
+static void check(string_view name, string_view pattern, Matcher goto_matcher, Matcher table_matcher, string_view alphabet)
+{
+    cout << name << ": ";
+
+    fa::dfa::Table table{ fa::nfa::compile(pattern) };
+    srand(42);
+    for (size_t i = 0; i < 10000; i++) {
+        string input;
+        for (size_t j = rand() % 24; j > 0; j--) {
+            input.push_back(alphabet[rand() % alphabet.size()]);
+        }
+        assert(goto_matcher(input) == table.matches(input));
+        assert(table_matcher(input) == table.matches(input));
+    }
+
+    cout << "OK.\n";
+}
+
+int main()
+{
+    check("log_error", goto_matchers::log_error_pattern,
+        goto_matchers::log_error, table_matchers::log_error, "ERO 0129:ab");
+    check("ipv4", goto_matchers::ipv4_pattern,
+        goto_matchers::ipv4, table_matchers::ipv4, "0192.5");
+    check("identifier", goto_matchers::identifier_pattern,
+        goto_matchers::identifier, table_matchers::identifier, "aZ_09-");
+
+    assert(goto_matchers::log_error("ERROR 42: disk full"));
+    assert(table_matchers::ipv4("192.168.0.1"));
+    assert(!goto_matchers::ipv4("192.168.0"));
+
+    return 0;
+}
@@ -0,0 +1,151 @@
+/**
+ * Checks the quantifiers (?, *, + and {n,m}) on fragments whose in or out state is part of an inner loop,
+ * both through the combinators and through the parser.
+ */
+#include <cassert>
+#include <iostream>
+
+#include <fa/nfa/nfa.h>
+#include <fa/nfa/parser.h>
+
+using namespace std;
+using namespace fa::nfa;
+
+static void test_opt_inner_loop()
+{
+    cout << __func__ << ": ";
+
+    // (a+b)?: the loop of a+ comes back to the in state of the fragment
+    NFA nfa = opt(concat(oneOrMore(NFA{'a'}), NFA{'b'}));
+    assert(nfa.matches(""));
+    assert(nfa.matches("ab"));
+    assert(nfa.matches("aab"));
+    assert(!nfa.matches("a"));
+    assert(!nfa.matches("aa"));
+    assert(!nfa.matches("b"));
+
+    // (ab*)?: the loop of b* leaves from the out state of the fragment
+    nfa = opt(concat(NFA{'a'}, zeroOrMore(NFA{'b'})));
+    assert(nfa.matches(""));
+    assert(nfa.matches("abb"));
+    assert(!nfa.matches("b"));
+
+    cout << "OK.\n";
+}
+
+static void test_zero_or_more_inner_loop()
+{
+    cout << __func__ << ": ";
+
+    // (ab*)*
+    NFA nfa = zeroOrMore(concat(NFA{'a'}, zeroOrMore(NFA{'b'})));
+    assert(nfa.matches(""));
+    assert(nfa.matches("a"));
+    assert(nfa.matches("abbab"));
+    assert(!nfa.matches("b"));
+    assert(!nfa.matches("bb"));
+    assert(!nfa.matches("ba"));
+
+    // (a+b)*
+    nfa = zeroOrMore(concat(oneOrMore(NFA{'a'}), NFA{'b'}));
+    assert(nfa.matches(""));
+    assert(nfa.matches("abaab"));
+    assert(!nfa.matches("a"));
+    assert(!nfa.matches("aba"));
+
+    cout << "OK.\n";
+}
+
+static void test_repeat_inner_loop()
+{
+    cout << __func__ << ": ";
+
+    // (a+b){0,2}
+    NFA nfa = repeat(concat(oneOrMore(NFA{'a'}), NFA{'b'}), 0, 2);
+    assert(nfa.matches(""));
+    assert(nfa.matches("abaab"));
+    assert(!nfa.matches("a"));
+    assert(!nfa.matches("aba"));
+    assert(!nfa.matches("ababab"));
+
+    // (ab*){1,2}
+    nfa = repeat(concat(NFA{'a'}, zeroOrMore(NFA{'b'})), 1, 2);
+    assert(nfa.matches("a"));
+    assert(nfa.matches("abbab"));
+    assert(!nfa.matches(""));
+    assert(!nfa.matches("b"));
+    assert(!nfa.matches("aaa"));
+
+    cout << "OK.\n";
+}
+
+static void test_parser_inner_loop()
+{
+    cout << __func__ << ": ";
+
+    assert(compile("(a+b)?").matches(""));
+    assert(compile("(a+b)?").matches("aab"));
+    assert(!compile("(a+b)?").matches("a"));
+
+    assert(compile("(ab*)*").matches("abba"));
+    assert(!compile("(ab*)*").matches("b"));
+
+    assert(compile("(a*b)+").matches("bab"));
+    assert(!compile("(a*b)+").matches("a"));
+
+    assert(compile("(a+b){0,2}").matches("abaab"));
+    assert(!compile("(a+b){0,2}").matches("aba"));
+
+    cout << "OK.\n";
+}
+
+static NFA repeat_merged(size_t min, size_t max)
+{
+    NFA a = concat(oneOrMore(NFA{'a'}), NFA{'b'});
+    // a's graph is merged into the bigger one, and only survives through a
+    NFA other = concat(NFA{'x'}, NFA{'y'}, NFA{'z'}, NFA{'x'}, NFA{'y'}, NFA{'z'}) + a;
+    return repeat(a, min, max);
+}
+
+static void test_merged_fragment()
+{
+    cout << __func__ << ": ";
+
+    NFA nfa = repeat_merged(1, 2);
+    assert(nfa.matches("ab"));
+    assert(nfa.matches("aabab"));
+    assert(!nfa.matches("a"));
+    assert(!nfa.matches("aba"));
+
+    nfa = repeat_merged(0, 1);
+    assert(nfa.matches(""));
+    assert(nfa.matches("aab"));
+    assert(!nfa.matches("a"));
+
+    NFA a = concat(NFA{'a'}, zeroOrMore(NFA{'b'}));
+    NFA other = concat(NFA{'x'}, NFA{'y'}, NFA{'z'}, NFA{'x'}, NFA{'y'}, NFA{'z'}) + a;
+    nfa = zeroOrMore(a);
+    assert(nfa.matches(""));
+    assert(nfa.matches("abba"));
+    assert(!nfa.matches("b"));
+
+    a = concat(oneOrMore(NFA{'a'}), NFA{'b'});
+    other = concat(NFA{'x'}, NFA{'y'}, NFA{'z'}, NFA{'x'}, NFA{'y'}, NFA{'z'}) + a;
+    nfa = opt(a);
+    assert(nfa.matches(""));
+    assert(nfa.matches("aab"));
+    assert(!nfa.matches("a"));
+
+    cout << "OK.\n";
+}
+
+int main()
+{
+    test_opt_inner_loop();
+    test_zero_or_more_inner_loop();
+    test_repeat_inner_loop();
+    test_parser_inner_loop();
+    test_merged_fragment();
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+/**
+ * Checks that counted repetition clones its fragment in time and memory linear on the repeat count,
+ * by counting the bytes allocated while building large repeats.
+ */
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include <fa/nfa/nfa.h>
+#include <fa/nfa/parser.h>
+
+using namespace std;
+using namespace fa::nfa;
+
+// bytes allocated by the replaced global operator new (the test is single threaded)
+static size_t allocated_bytes = 0;
+
+void* operator new(size_t size)
+{
+    void* pointer = malloc(size);
+    if (!pointer) {
+        throw bad_alloc{};
+    }
+    allocated_bytes += size;
+    return pointer;
+}
+
+void operator delete(void* pointer) noexcept
+{
+    free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    free(pointer);
+}
+
+// far above what a copy of a small fragment needs, far below a per copy allocation sized to the graph
+static constexpr size_t MAX_BYTES_PER_COPY = 1024;
+
+static void test_repeat_allocations()
+{
+    cout << __func__ << ": ";
+
+    constexpr size_t COPIES = 100000;
+    size_t before = allocated_bytes;
+    NFA nfa = repeat(concat(NFA{'x'}, NFA{'y'}), COPIES, COPIES);
+    assert(allocated_bytes - before < COPIES * MAX_BYTES_PER_COPY);
+    string input;
+    for (size_t i = 0; i < COPIES; i++) {
+        input += "xy";
+    }
+    assert(nfa.matches(input));
+    assert(!nfa.matches(input.substr(2)));
+
+    before = allocated_bytes;
+    nfa = repeat(NFA{'x'}, 0, COPIES);
+    assert(allocated_bytes - before < COPIES * MAX_BYTES_PER_COPY);
+
+    cout << "OK.\n";
+}
+
+static void test_compile_allocations()
+{
+    cout << __func__ << ": ";
+
+    constexpr size_t COPIES = 200000;
+    size_t before = allocated_bytes;
+    NFA nfa = compile("x{" + to_string(COPIES) + "}");
+    assert(allocated_bytes - before < COPIES * MAX_BYTES_PER_COPY);
+    assert(nfa.matches(string(COPIES, 'x')));
+    assert(!nfa.matches(string(COPIES - 1, 'x')));
+
+    cout << "OK.\n";
+}
+
+int main()
+{
+    test_repeat_allocations();
+    test_compile_allocations();
+
+    return 0;
+}